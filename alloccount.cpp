@@ -0,0 +1,180 @@
+#include "alloccount.hpp"
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+/*
+ * Replaces the global allocation functions so that allocationCount() can
+ * prove that steady-state ticks and frames do not allocate.
+ *
+ * With glibc, malloc(), calloc(), realloc() and aligned_alloc() are replaced
+ * too, forwarding to the C library's own allocator, so that the allocations
+ * of fmt, SDL and C code are counted along with the operator new ones, which
+ * go through them. Elsewhere only operator new is counted.
+ */
+static std::atomic<size_t> g_allocations {0};
+
+size_t allocationCount()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+#ifdef __GLIBC__
+#    define ALLOCCOUNT_MALLOC 1
+
+extern "C"
+{
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* p, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* p, size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(alignment, size);
+}
+}
+#else
+#    define ALLOCCOUNT_MALLOC 0
+#endif
+
+/* Null when out of memory, the throwing operators abort then (there are no exceptions) */
+static void* countedAlloc(size_t size)
+{
+#if !ALLOCCOUNT_MALLOC
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+#endif
+    return malloc(size ? size : 1);
+}
+
+static void* countedAlignedAlloc(size_t size, std::align_val_t alignment)
+{
+#if !ALLOCCOUNT_MALLOC
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+#endif
+    auto align = static_cast<size_t>(alignment);
+    size = ((size ? size : 1) + align - 1) & ~(align - 1);
+#ifdef _MSC_VER
+    return _aligned_malloc(size, align);
+#else
+    return aligned_alloc(align, size);
+#endif
+}
+
+static void* orAbort(void* p)
+{
+    if (!p)
+    {
+        abort();
+    }
+    return p;
+}
+
+static void alignedFree(void* p)
+{
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void* operator new(size_t size)
+{
+    return orAbort(countedAlloc(size));
+}
+
+void* operator new[](size_t size)
+{
+    return orAbort(countedAlloc(size));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return orAbort(countedAlignedAlloc(size, alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return orAbort(countedAlignedAlloc(size, alignment));
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return countedAlignedAlloc(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return countedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    alignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    alignedFree(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+    alignedFree(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept
+{
+    alignedFree(p);
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <stddef.h>
+
+/*
+ * Number of allocations since startup, all threads included: calls to the
+ * global operator new, and with glibc to malloc(), calloc(), realloc() and
+ * aligned_alloc() from any code.
+ */
+size_t allocationCount();
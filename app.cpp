@@ -1,334 +1,368 @@
 #include "app.hpp"
 
+#include "alloccount.hpp"
+#include "fixedworld.hpp"
 #include "font.hpp"
+#include <algorithm>
 #include <assert.h>
 #include <chrono>
 #include <fmt/format.h>
-#include <optional>
-
-/*** Utility functions ****************************************************************/
-static bool isColliding(const Entity& a, const Entity& b)
-{
-    return
-        /* left side of a is at the left of the right side of b */
-        (a.pos.x - (a.size.x / 2.0f) < b.pos.x + (b.size.x / 2.0f)) &&
-
-        /* right side of a is at the right of the left side of b */
-        (a.pos.x + (a.size.x / 2.0f) > b.pos.x - (b.size.x / 2.0f)) &&
-
-        /* top side of a is over botton side of b */
-        (a.pos.y - (a.size.y / 2.0f) < b.pos.y + (b.size.y / 2.0f)) &&
-
-        /* bottom side of a is underneath top side of b */
-        (a.pos.y + (a.size.y / 2.0f) > b.pos.y - (b.size.y / 2.0f));
-}
-
-static std::optional<glm::vec2> penetrationVector(const Entity& a, const Entity& b)
-{
-    glm::vec2 d = b.pos - a.pos;
-    float px = (a.size.x / 2.0f + b.size.x / 2.0f) - std::abs(d.x);
-    float py = (a.size.y / 2.0f + b.size.y / 2.0f) - std::abs(d.y);
-    if (px <= 0.0f || py <= 0.0f)
-    {
-        return std::nullopt;
-    }
-
-    if (px < py)
-    {
-        return glm::vec2 {d.x < 0.0f ? -px : px, 0.0f};
-    }
-    else
-    {
-        return glm::vec2 {0.0f, d.y < 0.0f ? -py : py};
-    }
-}
+#include <iterator>
 
 /*** Member functions *****************************************************************/
 App::App()
     : _window(nullptr),
       _renderer(nullptr),
-      _prevTime(0.0),
-      _lag(0.0),
+      _audioStream(nullptr),
+      _frameArena(ARENA_SIZE),
+      _replay(false),
+      _linkTime(0),
+      _frameRollback(0),
+      _frameResimulate(0.0),
+      _tickMs(0.0),
+      _frameMs(0.0),
       _theta(0.0f),
-      _fpsTimer(0.0),
+      _fpsTimer(0),
       _frames(0),
       _fps(0),
-      _scores {0, 0},
-      _ball(nullptr),
-      _idle(false),
+      _frameAllocations(0),
       _vSync(false)
-
-
 {
     memset(&_keyState, 0, sizeof(_keyState));
-    _rng.seed(std::chrono::system_clock::now().time_since_epoch().count());
-}
-
-void App::reset()
-{
-    _ball->pos.x = _ball->pos.y = 0.0f;
-    _ball->v.x = _ball->v.y = 0.0f;
-    _idle = true;
 }
 
 SDL_AppResult App::onInit(int argc, char** argv)
 {
-    auto flags = SDL_WINDOW_RESIZABLE;
-    auto ret = SDL_CreateWindowAndRenderer("Pong", SCREEN_WIDTH, SCREEN_HEIGHT, flags, &_window, &_renderer);
-    if (!ret)
-    {
-        return SDL_APP_FAILURE;
-    }
-    _vSync = SDL_SetRenderVSync(_renderer, 1);
-
-    _startSound.load("start.ogg");
-    _bounceSound.load("bounce.ogg");
-    _loseSound.load("lose.ogg");
-
-    SDL_AudioSpec inAudioSpec;
-    inAudioSpec.format = SDL_AUDIO_S16LE;
-    inAudioSpec.channels = _startSound.channels();
-    inAudioSpec.freq = _startSound.sampleRate();
-
-    _audioStream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &inAudioSpec, nullptr, nullptr);
-    if (!_audioStream)
-    {
-        fmt::println(stderr, "Failed to create audio stream");
-    }
-    else
+    const char* broadphase = nullptr;
+    const char* narrowphase = nullptr;
+    const char* physics = nullptr;
+    const char* replay = nullptr;
+    const char* catchUpPolicy = nullptr;
+    const char* bot = nullptr;
+    const char* mlp = nullptr;
+    const char* table = nullptr;
+    int tickRate = World::FPS;
+    int catchUp = _scheduler.maxCatchUp();
+    double timeScale = 1.0;
+    int frameRate = -1; /* vsync */
+    bool loopback = false;
+    LinkConditions conditions {50.0, 10.0, 0.02};
+    bool headless = false;
+    size_t balls = 1;
+    uint64_t ticks = 0; /* 0 for a minute of play at the tick rate */
+    uint64_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    for (int i = 1; i < argc; i++)
     {
-        if (!SDL_ResumeAudioStreamDevice(_audioStream))
+        if (!strcmp(argv[i], "--broadphase") && i + 1 < argc)
         {
-            fmt::println(stderr, "Failed to resume audio stream playback");
+            broadphase = argv[++i];
         }
-    }
-    /* Separator lines */
-    for (int i = 0; i < 21; i++)
-    {
-        auto entity = std::make_unique<Entity>();
-        entity->pos = {0.0f, -0.5f + (i * 0.05f)};
-        entity->size = {0.005f, 0.03f};
-        entity->flags = Entity::DISPLAY;
-        entity->color.r = 0.5f;
-        entity->color.g = 0.5f;
-        entity->color.b = 0.5f;
-        _entities.push_back(std::move(entity));
-    }
-
-    std::unique_ptr<Entity> entity;
-
-    auto bounce = [](Entity& self, Entity& ball, glm::vec2 pv)
-    {
-        ball.pos += glm::vec2 {pv.x, pv.y};
-        if (pv.x < 0.0f || pv.x > 0.0f) /* horizontal collision */
+        else if (!strcmp(argv[i], "--narrowphase") && i + 1 < argc)
         {
-            ball.v.x = -ball.v.x;
+            narrowphase = argv[++i];
         }
-        if (pv.y < 0.0f || pv.y > 0.0f) /* vertical collision */
+        else if (!strcmp(argv[i], "--physics") && i + 1 < argc)
         {
-            ball.v.y = -ball.v.y;
+            physics = argv[++i];
         }
-    };
-
-    /* Left wall */
-    entity = std::make_unique<Entity>();
-    entity->size = {0.1f, GAME_HEIGHT + 0.2f};
-    entity->pos = {(-GAME_WIDTH / 2.0f) - (entity->size.x / 2.0f), 0.0f};
-    entity->flags = Entity::PHYSICS;
-    entity->color.r = 1.0f;
-    entity->color.g = 0.5f;
-    entity->color.b = 1.0f;
-    entity->onCollision = [this, bounce](Entity& self, Entity& other, glm::vec2 pv)
-    {
-        if (&other == _ball)
+        else if (!strcmp(argv[i], "--headless"))
         {
-            _scores[1]++;
-            reset();
-            playSound(_loseSound);
+            headless = true;
         }
-    };
-    entity->name = "leftwall";
-    _entities.push_back(std::move(entity));
-
-    /* Right wall */
-    entity = std::make_unique<Entity>();
-    entity->size = {0.1f, GAME_HEIGHT + 0.2f};
-    entity->pos = {(GAME_WIDTH / 2.0f) + (entity->size.x / 2.0f), 0.0f};
-    entity->flags = Entity::PHYSICS;
-    entity->color.r = 1.0f;
-    entity->color.g = 0.5f;
-    entity->color.b = 1.0f;
-    entity->onCollision = [this, bounce](Entity& self, Entity& other, glm::vec2 pv)
-    {
-        if (&other == _ball)
+        else if (!strcmp(argv[i], "--ticks") && i + 1 < argc)
         {
-            _scores[0]++;
-            reset();
-            playSound(_loseSound);
+            ticks = strtoull(argv[++i], nullptr, 10);
         }
-    };
-    entity->name = "rightwall";
-    _entities.push_back(std::move(entity));
-
-    /* Top wall */
-    entity = std::make_unique<Entity>();
-    entity->size = {GAME_WIDTH, 0.1f};
-    entity->pos = {0, -0.5f - (entity->size.y / 2.0f)};
-    entity->flags = Entity::PHYSICS;
-    entity->color.r = 0.5f;
-    entity->color.g = 1.0f;
-    entity->color.b = 1.0f;
-    entity->onCollision = [this, bounce](Entity& self, Entity& other, glm::vec2 pv)
-    {
-        if (&other == _ball)
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc)
         {
-            bounce(self, other, pv);
+            seed = strtoull(argv[++i], nullptr, 10);
         }
-    };
-    entity->name = "topwall";
-    _entities.push_back(std::move(entity));
+        else if (!strcmp(argv[i], "--record") && i + 1 < argc)
+        {
+            _recordPath = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--replay") && i + 1 < argc)
+        {
+            replay = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--timescale") && i + 1 < argc)
+        {
+            timeScale = strtod(argv[++i], nullptr);
+        }
+        else if (!strcmp(argv[i], "--tickrate") && i + 1 < argc)
+        {
+            tickRate = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--framerate") && i + 1 < argc)
+        {
+            frameRate = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--catchup") && i + 1 < argc)
+        {
+            catchUp = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--catchup-policy") && i + 1 < argc)
+        {
+            catchUpPolicy = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--loopback"))
+        {
+            loopback = true;
+        }
+        else if (!strcmp(argv[i], "--latency") && i + 1 < argc)
+        {
+            conditions.latencyMs = strtod(argv[++i], nullptr);
+        }
+        else if (!strcmp(argv[i], "--jitter") && i + 1 < argc)
+        {
+            conditions.jitterMs = strtod(argv[++i], nullptr);
+        }
+        else if (!strcmp(argv[i], "--bot") && i + 1 < argc)
+        {
+            bot = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--mlp") && i + 1 < argc)
+        {
+            mlp = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--table") && i + 1 < argc)
+        {
+            table = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--balls") && i + 1 < argc)
+        {
+            balls = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (!strcmp(argv[i], "--loss") && i + 1 < argc)
+        {
+            conditions.loss = strtod(argv[++i], nullptr) / 100.0;
+        }
+    }
 
-    /* Bottom wall */
-    entity = std::make_unique<Entity>();
-    entity->size = {GAME_WIDTH, 0.1f};
-    entity->pos = {0.0f, 0.5f + (entity->size.y / 2.0f)};
-    entity->flags = Entity::PHYSICS;
-    entity->color.r = 0.5f;
-    entity->color.g = 1.0f;
-    entity->color.b = 1.0f;
-    entity->onCollision = [this, bounce](Entity& self, Entity& other, glm::vec2 pv)
+    if (broadphase)
     {
-        if (&other == _ball)
+        auto backend = createBroadphase(broadphase);
+        if (!backend)
         {
-            bounce(self, other, pv);
-        }
-    };
-    entity->name = "bottomwall";
-    _entities.push_back(std::move(entity));
-
-    /* Ball */
-    entity = std::make_unique<Entity>();
-    entity->pos = {0.0f, 0.0f};
-    entity->size = {0.05f, 0.05f};
-    entity->flags = Entity::DISPLAY | Entity::PHYSICS;
-    entity->color.r = 1.0f;
-    entity->color.g = 1.0f;
-    entity->color.b = 1.0f;
-    entity->v = {0.0f, 0.0f};
-    entity->onUpdate = [this](Entity& ball, const Keystate& keyState)
-    {
-        if (keyState.space)
-        {
-            if (_idle)
-            {
-                do
-                {
-                    ball.v = glm::vec2 {(_rng.fnext() * 2.0f) - 1.0f, (_rng.fnext() * 2.0f) - 1.0f};
-                } while (ball.v.x < 0.01f);
-                playSound(_startSound);
-                _idle = false;
-            }
+            fmt::println(stderr, "Unknown broadphase {}, expected brute, grid or sap", broadphase);
+            return SDL_APP_FAILURE;
         }
+        _world.setBroadphase(std::move(backend));
+    }
 
-        if (glm::length(ball.v))
+    if (narrowphase)
+    {
+        auto kernel = findNarrowphase(narrowphase);
+        if (!kernel)
         {
-            ball.v = glm::normalize(ball.v) * BALL_SPEED;
+            fmt::println(stderr, "Narrowphase {} is unknown or not supported by this CPU", narrowphase);
+            return SDL_APP_FAILURE;
         }
-    };
-    entity->name = "ball";
-    _ball = entity.get();
-    _entities.push_back(std::move(entity));
+        _world.setNarrowphase(*kernel);
+    }
 
-    /* Paddles */
-    entity = std::make_unique<Entity>();
-    entity->pos = {-(GAME_WIDTH / 2.0f) + 0.1f, 0.0f};
-    entity->size = {_ball->size.x, 0.2f};
-    entity->flags = Entity::DISPLAY | Entity::PHYSICS;
-    entity->color.r = 1.0f;
-    entity->color.g = 0.75f;
-    entity->color.b = 0.5f;
-    entity->onCollision = [this, bounce](Entity& self, Entity& other, glm::vec2 pv)
+    if (physics)
     {
-        if (&other == _ball)
+        if (!strcmp(physics, "fixed"))
         {
-            bounce(self, other, pv);
-            playSound(_bounceSound);
+            _world.setPhysics(World::Physics::FIXED);
         }
-        else /* assume wall */
+        else if (strcmp(physics, "float"))
         {
-            self.pos += -pv;
+            fmt::println(stderr, "Unknown physics {}, expected float or fixed", physics);
+            return SDL_APP_FAILURE;
         }
-    };
-    entity->onUpdate = [](Entity& p1, const Keystate& keyState)
+    }
+
+    auto skill = findBotSkill(bot ? bot : "normal");
+    if (!skill)
+    {
+        fmt::println(stderr, "Unknown bot {}, expected easy, normal, hard or perfect", bot);
+        return SDL_APP_FAILURE;
+    }
+
+    if (catchUpPolicy)
     {
-        if (keyState.up)
+        if (!strcmp(catchUpPolicy, "slow"))
         {
-            p1.v.y = -PADDLE_SPEED;
+            _scheduler.setPolicy(Scheduler::Policy::SLOW_DOWN);
         }
-        else if (keyState.down)
+        else if (strcmp(catchUpPolicy, "drop"))
         {
-            p1.v.y = PADDLE_SPEED;
+            fmt::println(stderr, "Unknown catch-up policy {}, expected drop or slow", catchUpPolicy);
+            return SDL_APP_FAILURE;
         }
-        else
+    }
+
+    /* A replay brings its own seed, physics, tick rate and bot */
+    if (replay)
+    {
+        if (!_recording.load(replay))
         {
-            p1.v.y = 0.0f;
+            fmt::println(stderr, "Failed to load recording {}", replay);
+            return SDL_APP_FAILURE;
         }
-    };
-    entity->name = "rightpaddle";
-    _entities.push_back(std::move(entity));
+        _replay = true;
+        _recordPath.clear();
+        seed = _recording.seed();
+        ticks = _recording.ticks();
+        _world.setPhysics(_recording.physics());
+        tickRate = _recording.tickRate();
+        skill = &_recording.bot();
+    }
+    else if (!_recordPath.empty())
+    {
+        _recording.start(seed, _world.physics(), tickRate, skill);
+    }
+    _world.setBotSkill(*skill);
+
+    if (tickRate <= 0 || tickRate > UINT16_MAX)
+    {
+        fmt::println(stderr, "Invalid tick rate {}", tickRate);
+        return SDL_APP_FAILURE;
+    }
+    if (_world.physics() == World::Physics::FIXED && (tickRate < FixedWorld::MIN_TICK_RATE || tickRate > FixedWorld::MAX_TICK_RATE))
+    {
+        fmt::println(stderr, "Invalid tick rate {} for the fixed physics, expected {} to {}", tickRate, FixedWorld::MIN_TICK_RATE, FixedWorld::MAX_TICK_RATE);
+        return SDL_APP_FAILURE;
+    }
+    _world.setTickRate(tickRate);
+    _scheduler.setTickRate(tickRate);
+    if (!ticks)
+    {
+        ticks = 60 * static_cast<uint64_t>(tickRate);
+    }
+
+    if (catchUp < 1)
+    {
+        fmt::println(stderr, "Invalid catch-up {}, expected at least 1 tick per frame", catchUp);
+        return SDL_APP_FAILURE;
+    }
+    _scheduler.setMaxCatchUp(catchUp);
 
-    entity = std::make_unique<Entity>();
-    entity->pos = {(GAME_WIDTH / 2.0f) - 0.1f, 0.0f};
-    entity->size = {_ball->size.x, 0.2f};
-    entity->flags = Entity::DISPLAY | Entity::PHYSICS;
-    entity->color.r = 1.0f;
-    entity->color.g = 0.5f;
-    entity->color.b = 1.0f;
-    entity->onCollision = [this, bounce](Entity& self, Entity& other, glm::vec2 pv)
+    if (!(timeScale > 0.0 && timeScale <= Scheduler::MAX_TIME_SCALE))
     {
-        if (&other == _ball)
+        fmt::println(stderr, "Invalid time scale {}, expected more than 0 and at most {}", timeScale, Scheduler::MAX_TIME_SCALE);
+        return SDL_APP_FAILURE;
+    }
+    _scheduler.setTimeScale(timeScale);
+
+    if (balls != 1)
+    {
+        if (balls < 1 || balls > World::MAX_BALLS)
         {
-            bounce(self, other, pv);
-            playSound(_bounceSound);
+            fmt::println(stderr, "Invalid number of balls {}, expected 1 to {}", balls, World::MAX_BALLS);
+            return SDL_APP_FAILURE;
         }
-        else /* assume wall */
+        if (_world.physics() == World::Physics::FIXED || loopback || replay || !_recordPath.empty())
         {
-            self.pos += -pv;
+            fmt::println(stderr, "Multiball only plays the float physics, and can not be recorded, replayed nor played over --loopback");
+            return SDL_APP_FAILURE;
         }
-    };
-    entity->onUpdate = [this](Entity& self, const Keystate& keyState)
+        _world.setBalls(balls);
+    }
+
+    if (bot && _world.physics() == World::Physics::FIXED)
     {
-        if (_ball->v.x > 0.0f && _ball->pos.y < self.pos.y)
+        fmt::println(stderr, "The bot only plays the float physics, the fixed physics plays the CPU chase");
+        return SDL_APP_FAILURE;
+    }
+
+    if (mlp || table)
+    {
+        if (_world.physics() == World::Physics::FIXED || loopback || replay || !_recordPath.empty())
         {
-            self.v.y = -PADDLE_SPEED;
+            fmt::println(stderr, "A learned policy or a table only plays the float physics, and can not be recorded, replayed nor played over --loopback");
+            return SDL_APP_FAILURE;
         }
-        else if (_ball->v.x > 0.0f && _ball->pos.y > self.pos.y)
+        if (mlp && !_policy.load(mlp))
         {
-            self.v.y = PADDLE_SPEED;
+            fmt::println(stderr, "Failed to load policy {}", mlp);
+            return SDL_APP_FAILURE;
         }
-        else if (_ball->v.x < 0.0f && _ball->pos.y < self.pos.y)
+        if (table && !_table.map(table))
         {
-            self.v.y = PADDLE_SPEED;
+            fmt::println(stderr, "Failed to map table {}", table);
+            return SDL_APP_FAILURE;
         }
-        else if (_ball->v.x < 0.0f && _ball->pos.y > self.pos.y)
+        _world.setPolicy(mlp ? &_policy : nullptr);
+        _world.setTable(table ? &_table : nullptr);
+    }
+
+    if (loopback)
+    {
+        if (replay || !_recordPath.empty())
         {
-            self.v.y = -PADDLE_SPEED;
+            fmt::println(stderr, "Recordings only hold the input of one player, --loopback can not be recorded nor replayed");
+            return SDL_APP_FAILURE;
         }
-        else
+        if (!(conditions.latencyMs >= 0.0 && conditions.latencyMs <= LinkConditions::MAX_DELAY_MS) ||
+            !(conditions.jitterMs >= 0.0 && conditions.jitterMs <= LinkConditions::MAX_DELAY_MS))
         {
-            self.v.y = 0.0f;
+            fmt::println(stderr, "Invalid latency {} or jitter {}, expected 0 to {} ms", conditions.latencyMs, conditions.jitterMs, LinkConditions::MAX_DELAY_MS);
+            return SDL_APP_FAILURE;
         }
-    };
-    entity->name = "leftpaddle";
-    _entities.push_back(std::move(entity));
+        if (!(conditions.loss >= 0.0 && conditions.loss <= 1.0))
+        {
+            fmt::println(stderr, "Invalid loss {}%, expected 0 to 100", conditions.loss * 100.0);
+            return SDL_APP_FAILURE;
+        }
+        _remoteWorld = std::make_unique<World>();
+        _remoteWorld->setPhysics(_world.physics());
+        _remoteWorld->setTickRate(tickRate);
+        _remoteWorld->setPlayers(2);
+        _remoteWorld->init(seed);
+        _world.setPlayers(2);
+        _link = std::make_unique<LoopbackLink>(conditions, seed);
+    }
+
+    _world.init(seed);
+    if (_link)
+    {
+        _sessions[0] = std::make_unique<RollbackSession>(_world, _link->end(0), 0);
+        _sessions[1] = std::make_unique<RollbackSession>(*_remoteWorld, _link->end(1), 1);
+    }
+    if (headless)
+    {
+        return runHeadless(ticks);
+    }
 
-    for (auto& e : _entities)
+    auto flags = SDL_WINDOW_RESIZABLE;
+    auto ret = SDL_CreateWindowAndRenderer("Pong", SCREEN_WIDTH, SCREEN_HEIGHT, flags, &_window, &_renderer);
+    if (!ret)
+    {
+        return SDL_APP_FAILURE;
+    }
+    /* An explicit frame rate turns vsync off, 0 does not limit it at all */
+    if (frameRate < 0)
     {
-        e->origColor = e->color;
+        _vSync = SDL_SetRenderVSync(_renderer, 1);
+        frameRate = tickRate;
     }
+    _scheduler.setFrameRate(frameRate);
 
-    _idle = true;
+    _startSound.load("start.ogg");
+    _bounceSound.load("bounce.ogg");
+    _loseSound.load("lose.ogg");
+
+    SDL_AudioSpec inAudioSpec;
+    inAudioSpec.format = SDL_AUDIO_S16LE;
+    inAudioSpec.channels = _startSound.channels();
+    inAudioSpec.freq = _startSound.sampleRate();
 
+    _audioStream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &inAudioSpec, nullptr, nullptr);
+    if (!_audioStream)
+    {
+        fmt::println(stderr, "Failed to create audio stream");
+    }
+    else
+    {
+        if (!SDL_ResumeAudioStreamDevice(_audioStream))
+        {
+            fmt::println(stderr, "Failed to resume audio stream playback");
+        }
+    }
+    _scheduler.start(SDL_GetTicksNS());
     return SDL_APP_CONTINUE;
 }
 
@@ -366,6 +400,20 @@ SDL_AppResult App::onEvent(SDL_Event* event)
         {
             _keyState.space = event->type == SDL_EVENT_KEY_DOWN;
         }
+        else if (event->key.key == SDLK_B && event->type == SDL_EVENT_KEY_DOWN)
+        {
+            /* cycle through the broadphase backends */
+            static const char* const names[] = {"brute", "grid", "sap"};
+            size_t next = 0;
+            for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+            {
+                if (!strcmp(names[i], _world.broadphase().name()))
+                {
+                    next = (i + 1) % (sizeof(names) / sizeof(names[0]));
+                }
+            }
+            _world.setBroadphase(createBroadphase(names[next]));
+        }
     }
     break;
     }
@@ -374,36 +422,41 @@ SDL_AppResult App::onEvent(SDL_Event* event)
 
 SDL_AppResult App::onIterate()
 {
-    auto beginTime = SDL_GetTicks() / 1000.0;
-    auto elapsed = beginTime - _prevTime;
-    _lag += elapsed;
-
-    while (_lag > dT)
+    auto allocations = allocationCount();
+    _frameRollback = 0;
+    _frameResimulate = 0.0;
+    auto beginTime = SDL_GetTicksNS();
+    auto ticks = _scheduler.beginFrame(beginTime);
+    for (int i = 0; i < ticks; i++)
     {
         onUpdate();
-        _lag -= dT;
     }
-    onRender(_lag / dT);
+    auto updateTime = SDL_GetTicksNS();
+    if (ticks)
+    {
+        _tickMs = (updateTime - beginTime) / (ticks * 1e6);
+    }
+    onRender(_scheduler.alpha());
+    _frameMs = (SDL_GetTicksNS() - beginTime) / 1e6;
 
     _frames++;
-    _fpsTimer += elapsed;
-    if (_fpsTimer >= 1.0)
+    _fpsTimer += _scheduler.stats().frameNs;
+    if (_fpsTimer >= Scheduler::SECOND)
     {
-        _fps = _frames / _fpsTimer;
-        _fpsTimer = 0.0;
+        _fps = static_cast<int>((_frames * Scheduler::SECOND) / _fpsTimer);
+        _fpsTimer = 0;
         _frames = 0;
     }
 
     if (!_vSync)
     {
-        auto endTime = SDL_GetTicks() / 1000.0;
-        if (endTime - beginTime < 1.0 / FPS)
+        auto delay = _scheduler.frameDelay(SDL_GetTicksNS());
+        if (delay)
         {
-            auto delay = ((1.0 / FPS) - (endTime - beginTime)) * 1000;
-            SDL_Delay(static_cast<uint32_t>(delay));
+            SDL_DelayNS(delay);
         }
     }
-    _prevTime = beginTime;
+    _frameAllocations = allocationCount() - allocations;
 
     return SDL_APP_CONTINUE;
 }
@@ -411,48 +464,134 @@ SDL_AppResult App::onIterate()
 void App::onQuit(SDL_AppResult result)
 {
     SDL_DestroyAudioStream(_audioStream);
+    if (!_recordPath.empty() && !_recording.save(_recordPath.c_str()))
+    {
+        fmt::println(stderr, "Failed to save recording {}", _recordPath);
+    }
 }
 
-/* We start the ball movement after someone hits any key */
-void App::onUpdate()
+/*
+ * Runs the simulation at full speed without window nor audio device, serving
+ * as soon as the ball is idle, or replaying a whole recording.
+ */
+SDL_AppResult App::runHeadless(uint64_t ticks)
 {
-    _debugText.clear();
+    Keystate serve {};
+    serve.space = true;
 
-    std::vector<Entity*> entities;
-    for (auto& e : _entities)
+    uint64_t pairs = 0;
+    uint64_t contacts = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < ticks; i++)
     {
-        if (e->flags & Entity::PHYSICS)
+        auto input = nextInput(serve);
+        if (_link)
+        {
+            tickLoopback(input);
+        }
+        else
         {
-            entities.push_back(e.get());
+            _world.tick(input);
         }
-        if (e->onUpdate)
+        pairs += _world.pairTests();
+        contacts += _world.contactCount();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - begin).count();
+
+    auto scores = _world.scores();
+    fmt::println("ticks={} seconds={:.3f} ticks/s={:.0f} scores={}-{}", ticks, seconds, ticks / seconds, scores[0], scores[1]);
+    fmt::println("balls={} tick={:.3f}ms pairs/tick={:.1f} contacts/tick={:.1f}",
+                 _world.balls(),
+                 seconds * 1000.0 / ticks,
+                 static_cast<double>(pairs) / ticks,
+                 static_cast<double>(contacts) / ticks);
+    if (_link)
+    {
+        const auto& stats = _sessions[0]->stats();
+        fmt::println("simulated={} rollbacks={} stalls={} packets={} dropped={}", stats.tick, stats.rollbacks, stats.stalls, _link->sent(), _link->dropped());
+    }
+    if (!_recordPath.empty())
+    {
+        if (!_recording.save(_recordPath.c_str()))
         {
-            e->onUpdate(*e, _keyState);
+            fmt::println(stderr, "Failed to save recording {}", _recordPath);
+            return SDL_APP_FAILURE;
         }
+        _recordPath.clear(); /* already saved */
     }
+    return SDL_APP_SUCCESS;
+}
 
-    for (auto& e : entities)
+/* Input of the next tick: replayed, or the given one, recorded if asked to */
+Keystate App::nextInput(const Keystate& input)
+{
+    if (_replay)
     {
-        e->pos += e->v * dT;
+        Keystate replayed {}; /* nothing pressed once the recording is over */
+        _recording.next(replayed);
+        return replayed;
     }
+    if (!_recordPath.empty())
+    {
+        _recording.record(input);
+    }
+    return input;
+}
 
-    for (auto& a : entities)
+/* Up or down towards the ball, what the bot on the other end of the loopback plays */
+static Keystate botInput(const World& world, int side)
+{
+    const auto& entities = world.entities();
+    auto ball = entities.pos()[entities.index(world.ball())];
+    Keystate input {};
+    for (size_t i = 0; i < entities.count(); i++)
     {
-        for (const auto& b : entities)
+        auto behavior = entities.behavior()[i];
+        if (behavior.kind == Behavior::PADDLE && behavior.player == side)
         {
-            if (a != b)
-            {
-                auto pv = penetrationVector(*a, *b);
-                if (pv)
-                {
-                    if (a->onCollision)
-                    {
-                        a->onCollision(*a, *b, *pv);
-                    }
-                }
-            }
+            input.up = ball.y < entities.pos()[i].y - (PADDLE_HEIGHT / 4.0f);
+            input.down = ball.y > entities.pos()[i].y + (PADDLE_HEIGHT / 4.0f);
         }
     }
+    return input;
+}
+
+/*
+ * One tick of both peers of the loopback. The local World may not move if it
+ * waits for the bot's inputs, the events are those of the tick it simulated.
+ */
+uint8_t App::tickLoopback(const Keystate& input)
+{
+    _linkTime += Scheduler::SECOND / _world.tickRate();
+    _link->setTime(_linkTime);
+
+    uint8_t events;
+    _sessions[1]->advance(botInput(*_remoteWorld, 1), events);
+    _sessions[0]->advance(input, events);
+
+    const auto& stats = _sessions[0]->stats();
+    _frameRollback = std::max(_frameRollback, stats.depth);
+    _frameResimulate += stats.resimulateMs;
+    return events;
+}
+
+void App::onUpdate()
+{
+    auto input = nextInput(_keyState);
+    auto events = _link ? tickLoopback(input) : _world.tick(input);
+    if (events & World::SERVED)
+    {
+        playSound(_startSound);
+    }
+    if (events & World::SCORED)
+    {
+        playSound(_loseSound);
+    }
+    if (events & World::PADDLE_BOUNCED)
+    {
+        playSound(_bounceSound);
+    }
 }
 
 static SDL_FRect getScreenSize(SDL_Renderer* renderer)
@@ -487,8 +626,9 @@ SDL_FRect transform(const Transformation& t, SDL_FRect rc)
     return rc;
 }
 
-void App::onRender(double lag)
+void App::onRender(double alpha)
 {
+    _frameArena.reset();
     auto screen = getScreenSize(_renderer);
 
     /* Clear screen */
@@ -617,45 +757,104 @@ void App::onRender(double lag)
     };
 
     /* Score */
+    auto scores = _world.scores();
     static const float scoreLocations[] = {-(GAME_WIDTH / 2.0f) + (SCORE_SIZE * 4.0f), (GAME_WIDTH / 2.0f) - (SCORE_SIZE * 8.0f)};
     for (int i = 0; i < 2; i++)
     {
-        auto digit1 = (_scores[i] / 10) % 10;
+        auto digit1 = (scores[i] / 10) % 10;
         if (digit1)
         {
             drawDigit(digit1 + '0', {scoreLocations[i], -0.48f}, COLOR_SCORE);
         }
 
-        auto digit2 = (_scores[i] % 10);
+        auto digit2 = (scores[i] % 10);
         drawDigit(digit2 + '0', {scoreLocations[i] + (SCORE_SIZE * 4.0f), -0.48f}, COLOR_SCORE);
     }
 
     /* Entities (they are just rectangles) */
-    for (const auto& entity : _entities)
+    const auto& entities = _world.entities();
+    auto count = entities.count();
+    auto entityPos = entities.pos();
+    auto entitySize = entities.size();
+    auto prevPos = _world.prevPos();
+    auto entityColor = entities.color();
+    auto entityFlags = entities.flags();
+
+    /* Consecutive entities of the same color are drawn at once, multiball being a single call */
+    ArenaVector<SDL_FRect> batch {ArenaAllocator<SDL_FRect>(&_frameArena)};
+    batch.reserve(count);
+    glm::vec3 batchColor {};
+    auto flush = [this, &batch, &batchColor]()
+    {
+        if (!batch.empty())
+        {
+            SDL_SetRenderDrawColor(_renderer, std::round(batchColor.r * 255), std::round(batchColor.g * 255), std::round(batchColor.b * 255), 0xFF);
+            SDL_RenderFillRects(_renderer, batch.data(), static_cast<int>(batch.size()));
+            batch.clear();
+        }
+    };
+    for (size_t i = 0; i < count; i++)
     {
-        if (entity->flags & Entity::DISPLAY)
+        if (entityFlags[i] & Entities::DISPLAY)
         {
-            glm::vec2 pos = entity->pos;
-            if (entity->flags & Entity::PHYSICS)
+            glm::vec2 pos = entityPos[i];
+            if (entityFlags[i] & Entities::PHYSICS)
             {
-                pos += entity->v * static_cast<float>(_lag) * dT;
+                pos = glm::mix(prevPos[i], pos, static_cast<float>(alpha));
             }
-            drawRect({pos.x - (entity->size.x / 2.0f), pos.y - (entity->size.y / 2.0f)}, entity->size, entity->color);
+            if (entityColor[i] != batchColor)
+            {
+                flush();
+                batchColor = entityColor[i];
+            }
+            SDL_FRect rc {pos.x - (entitySize[i].x / 2.0f), pos.y - (entitySize[i].y / 2.0f), entitySize[i].x, entitySize[i].y};
+            batch.push_back(transform(gameT, transform(screenT, rc)));
         }
     }
+    flush();
 
     /* Start text */
-    if (_idle)
+    if (_world.idle())
     {
         drawText("PRESS START", 0.01f, {-0.2f, 0.1f}, COLOR_SCORE);
     }
 
     /* Debug text */
-    auto debugText = fmt::format("fps={} {}", _fps, _debugText);
+    ArenaString debugText {ArenaAllocator<char>(&_frameArena)};
+    debugText.reserve(DEBUGTEXT_SIZE);
+    fmt::format_to(std::back_inserter(debugText),
+                   "fps={} allocs={} broadphase={} narrowphase={} awake={}/{} tests={} contacts={}",
+                   _fps,
+                   _frameAllocations,
+                   _world.broadphase().name(),
+                   _world.narrowphase().name,
+                   _world.awakeCount(),
+                   _world.movingCount(),
+                   _world.pairTests(),
+                   _world.contactCount());
     SDL_SetRenderClipRect(_renderer, nullptr);
     SDL_SetRenderDrawColor(_renderer, std::round(COLOR_DEBUGTEXT.r * 255), std::round(COLOR_DEBUGTEXT.g * 255), std::round(COLOR_DEBUGTEXT.b * 255), 0xFF);
     SDL_RenderDebugText(_renderer, 10.0f, 10.0f, debugText.c_str());
 
+    debugText.clear();
+    fmt::format_to(std::back_inserter(debugText), "balls={} tick={:.3f}ms frame={:.3f}ms", _world.balls(), _tickMs, _frameMs);
+    SDL_RenderDebugText(_renderer, 10.0f, 20.0f, debugText.c_str());
+
+    if (_link)
+    {
+        const auto& stats = _sessions[0]->stats();
+        debugText.clear();
+        fmt::format_to(std::back_inserter(debugText),
+                       "rollback depth={} resim={:.3f}ms tick={} behind={} rollbacks={} stalls={}",
+                       _frameRollback,
+                       _frameResimulate,
+                       stats.tick,
+                       static_cast<int64_t>(stats.tick) - stats.confirmed,
+                       stats.rollbacks,
+                       stats.stalls);
+        SDL_RenderDebugText(_renderer, 10.0f, 30.0f, debugText.c_str());
+    }
+
     /* Show into screen */
     SDL_RenderPresent(_renderer);
 }
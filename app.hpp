@@ -1,48 +1,28 @@
 #pragma once
 
-#include "rng.hpp"
+#include "arena.hpp"
+#include "mlp.hpp"
+#include "policytable.hpp"
+#include "recording.hpp"
+#include "rollback.hpp"
+#include "rules.hpp"
+#include "scheduler.hpp"
 #include "sfx.hpp"
+#include "transport.hpp"
+#include "world.hpp"
 #include <SDL3/SDL.h>
-#include <functional>
 #include <glm/glm.hpp>
 #include <memory>
-#include <optional>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
-struct Keystate
-{
-    bool up;
-    bool down;
-    bool left;
-    bool right;
-    bool space;
-};
-
 struct Rect
 {
     float x, y;
     float w, h;
 };
 
-struct Entity
-{
-    static constexpr auto DISPLAY = 1;
-    static constexpr auto PHYSICS = 2;
-
-    glm::vec2 pos; /* center */
-    glm::vec2 size;
-    glm::vec3 color;
-    glm::vec3 origColor;
-    glm::vec2 v;
-    glm::vec2 a;
-    std::optional<glm::vec2> pv; /* penetration vector */
-    unsigned flags;
-    std::function<void(Entity&, Entity&, glm::vec2)> onCollision;
-    std::function<void(Entity&, const Keystate&)> onUpdate;
-    std::string name;
-};
-
 /*
  * SDL_AppResult:
  *  - SDL_APP_FAILURE
@@ -52,16 +32,12 @@ struct Entity
 class App
 {
 public:
-    static constexpr auto GAME_WIDTH = 1.77f; /* 16:9 screen ratio */
-    static constexpr auto GAME_HEIGHT = 1.0f;
     static constexpr auto GAME_SCALE = 0.95f;
-    static constexpr auto BALL_SPEED = 0.75f;
-    static constexpr auto FPS = 60;
-    static constexpr auto PADDLE_SPEED = BALL_SPEED*0.8f;
     static constexpr auto SCREEN_HEIGHT = 540;
     static constexpr auto SCREEN_WIDTH = 960;
-    static constexpr auto dT = 1.0f / FPS;
     static constexpr auto SCORE_SIZE = 0.02f;
+    static constexpr auto ARENA_SIZE = 64 * 1024;
+    static constexpr auto DEBUGTEXT_SIZE = 128;
     static constexpr glm::vec3 COLOR_BACKGROUND = { 0.39f, 0.58f, 0.93f };
     static constexpr glm::vec3 COLOR_DEBUGTEXT = { 1.0f, 1.0f, 0.25f };
     static constexpr glm::vec3 COLOR_GAMESCREEN = { 0.04f, 0.04f, 0.04f };
@@ -78,27 +54,38 @@ private:
     SDL_Window* _window;
     SDL_Renderer* _renderer;
     SDL_AudioStream* _audioStream;
-    std::vector<std::unique_ptr<Entity>> _entities;
+    World _world;
+    Arena _frameArena; /* reset at the start of every onRender() */
     Keystate _keyState;
-    double _prevTime;
-    double _lag;
+    Recording _recording;
+    MlpPolicy _policy;  /* plays the right paddle when loaded with --mlp */
+    PolicyTable _table; /* same with --table */
+    std::string _recordPath; /* empty when not recording */
+    bool _replay;            /* input comes from _recording instead of the keyboard */
+    Scheduler _scheduler;
+    std::unique_ptr<LoopbackLink> _link; /* set for a two player match against a bot over rollback */
+    std::unique_ptr<World> _remoteWorld; /* what the bot's peer simulates */
+    std::unique_ptr<RollbackSession> _sessions[2];
+    uint64_t _linkTime;      /* ns, moves with the ticks */
+    int _frameRollback;      /* deepest rollback during the last frame */
+    double _frameResimulate; /* ms spent rolling back during the last frame */
+    double _tickMs;          /* average tick during the last frame which ran any */
+    double _frameMs;         /* ticks and rendering of the last frame, without waiting */
     float _theta;
-    double _fpsTimer;
+    uint64_t _fpsTimer; /* ns */
     int _frames;
     int _fps;
-    int _scores[2];
-    Entity* _ball;
-    std::string _debugText;
-    Rng _rng;
+    size_t _frameAllocations; /* global operator new calls during the last frame */
     Sfx _startSound;
     Sfx _bounceSound;
     Sfx _loseSound;
-    bool _idle;
     bool _vSync;
 
-    void reset();
+    SDL_AppResult runHeadless(uint64_t ticks);
+    Keystate nextInput(const Keystate& input);
+    uint8_t tickLoopback(const Keystate& input);
     void onUpdate();
-    void onRender(double lag);
+    void onRender(double alpha);
     void playSound(const Sfx& sound);
     static std::vector<unsigned char> loadFile(const char* filename);
 };
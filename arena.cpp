@@ -0,0 +1,80 @@
+#include "arena.hpp"
+
+#include <new>
+#include <stdint.h>
+
+static constexpr size_t ARENA_ALIGNMENT = 64;
+
+static unsigned char* allocateBuffer(size_t size)
+{
+    return static_cast<unsigned char*>(::operator new(size, std::align_val_t {ARENA_ALIGNMENT}));
+}
+
+static void freeBuffer(void* buffer)
+{
+    ::operator delete(buffer, std::align_val_t {ARENA_ALIGNMENT});
+}
+
+Arena::Arena(size_t capacity)
+    : _buffer(allocateBuffer(capacity)),
+      _capacity(capacity),
+      _used(0),
+      _overflowUsed(0),
+      _overflow(nullptr)
+{
+}
+
+Arena::~Arena()
+{
+    reset();
+    freeBuffer(_buffer);
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    auto base = reinterpret_cast<uintptr_t>(_buffer);
+    auto offset = ((base + _used + alignment - 1) & ~(alignment - 1)) - base;
+    if (offset + size <= _capacity)
+    {
+        _used = offset + size;
+        return _buffer + offset;
+    }
+
+    /* Out of space: serve from the heap until the next reset() grows the buffer */
+    auto header = (sizeof(Overflow) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+    auto block = allocateBuffer(header + size);
+    auto overflow = reinterpret_cast<Overflow*>(block);
+    overflow->next = _overflow;
+    _overflow = overflow;
+    _overflowUsed += size + alignment;
+    return block + header;
+}
+
+void Arena::reset()
+{
+    if (_overflow)
+    {
+        while (_overflow)
+        {
+            auto next = _overflow->next;
+            freeBuffer(_overflow);
+            _overflow = next;
+        }
+
+        freeBuffer(_buffer);
+        _capacity = (_used + _overflowUsed) * 2;
+        _buffer = allocateBuffer(_capacity);
+        _overflowUsed = 0;
+    }
+    _used = 0;
+}
+
+size_t Arena::used() const
+{
+    return _used + _overflowUsed;
+}
+
+size_t Arena::capacity() const
+{
+    return _capacity;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/*
+ * Bump allocator for transient, per-tick or per-frame data.
+ *
+ * Allocation is a pointer bump and nothing is ever freed individually; reset()
+ * releases everything at once. If a tick needs more than the capacity, the
+ * excess is served from overflow blocks and the next reset() grows the main
+ * buffer to the peak usage, so in steady state the arena never touches the heap.
+ */
+class Arena
+{
+public:
+    explicit Arena(size_t capacity);
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena();
+
+    void* allocate(size_t size, size_t alignment);
+    void reset();
+    size_t used() const;
+    size_t capacity() const;
+
+private:
+    struct Overflow
+    {
+        Overflow* next;
+    };
+
+    unsigned char* _buffer;
+    size_t _capacity;
+    size_t _used;
+    size_t _overflowUsed;
+    Overflow* _overflow;
+};
+
+/* STL allocator adaptor drawing from an Arena. deallocate() is a no-op. */
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena* arena)
+        : _arena(arena)
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+        : _arena(other.arena())
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t)
+    {
+    }
+
+    Arena* arena() const
+    {
+        return _arena;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const
+    {
+        return _arena == other.arena();
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const
+    {
+        return _arena != other.arena();
+    }
+
+private:
+    Arena* _arena;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
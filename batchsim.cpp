@@ -0,0 +1,498 @@
+#include "batchsim.hpp"
+
+#include "rules.hpp"
+#include "simd.hpp"
+#include "world.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <string.h>
+
+static constexpr auto LANE_WIDTH = 8;
+
+/* Ball center positions on contact, and the reach of the paddles */
+static constexpr float BALL_MAX_Y = (GAME_HEIGHT - BALL_SIZE) / 2.0f;
+static constexpr float FACE_X = ((GAME_WIDTH / 2.0f) - PADDLE_INSET) - ((PADDLE_WIDTH + BALL_SIZE) / 2.0f);
+static constexpr float SCORE_X = (GAME_WIDTH - BALL_SIZE) / 2.0f;
+static constexpr float PADDLE_MAX_Y = (GAME_HEIGHT - PADDLE_HEIGHT) / 2.0f;
+static constexpr float PADDLE_REACH = (PADDLE_HEIGHT + BALL_SIZE) / 2.0f;
+static constexpr float PADDLE_X = (GAME_WIDTH / 2.0f) - PADDLE_INSET;
+
+/*
+ * Both kernels evaluate the same operations in the same order, so that they
+ * agree to the bit. Conditions become 0/1 factors or selects, and a scoring
+ * lane is always written to scored but only counted when it did score.
+ */
+static size_t stepScalar(const BatchLanes& lanes, size_t count, uint32_t* scored)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        float bx = lanes.ballX[i];
+        float by = lanes.ballY[i];
+        float vx = lanes.ballVX[i];
+        float vy = lanes.ballVY[i];
+
+        /* CPU paddles chase an incoming ball and back away from an outgoing one */
+        for (int side = 0; side < 2; side++)
+        {
+            float dir = side ? vx : -vx;
+            float incoming = static_cast<float>(dir > 0.0f) - static_cast<float>(dir < 0.0f);
+            float py = lanes.paddleY[side][i];
+            float toward = static_cast<float>(by > py) - static_cast<float>(by < py);
+            py = py + lanes.cpu[side] * incoming * toward * lanes.paddleStep;
+            lanes.paddleY[side][i] = std::min(std::max(py, -PADDLE_MAX_Y), PADDLE_MAX_Y);
+        }
+
+        float nx = bx + vx * World::dT;
+        float ny = by + vy * World::dT;
+
+        bool below = ny > BALL_MAX_Y;
+        bool above = ny < -BALL_MAX_Y;
+        ny = below ? (2.0f * BALL_MAX_Y) - ny : ny;
+        ny = above ? (-2.0f * BALL_MAX_Y) - ny : ny;
+        vy = (below || above) ? -vy : vy;
+
+        bool hitRight = vx > 0.0f && bx <= FACE_X && nx > FACE_X && std::abs(ny - lanes.paddleY[1][i]) < PADDLE_REACH;
+        bool hitLeft = vx < 0.0f && bx >= -FACE_X && nx < -FACE_X && std::abs(ny - lanes.paddleY[0][i]) < PADDLE_REACH;
+        nx = hitRight ? (2.0f * FACE_X) - nx : nx;
+        nx = hitLeft ? (-2.0f * FACE_X) - nx : nx;
+        vx = (hitRight || hitLeft) ? -vx : vx;
+
+        bool rightWall = nx > SCORE_X;
+        bool leftWall = nx < -SCORE_X;
+        lanes.scores[0][i] += rightWall;
+        lanes.scores[1][i] += leftWall;
+        scored[n] = i;
+        n += rightWall || leftWall;
+
+        lanes.ballX[i] = nx;
+        lanes.ballY[i] = ny;
+        lanes.ballVX[i] = vx;
+        lanes.ballVY[i] = vy;
+    }
+    return n;
+}
+
+#ifdef SIMD_X86
+/* 1 where a > b, -1 where a < b, 0 otherwise */
+TARGET_AVX2 static __m256 signAvx2(__m256 a, __m256 b)
+{
+    const auto one = _mm256_set1_ps(1.0f);
+    return _mm256_sub_ps(_mm256_and_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ), one), _mm256_and_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ), one));
+}
+
+TARGET_AVX2 static void stepPaddleAvx2(float* paddleY, __m256 cpu, __m256 incoming, __m256 by, __m256 step)
+{
+    auto py = _mm256_load_ps(paddleY);
+    auto toward = signAvx2(by, py);
+    py = _mm256_add_ps(py, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(cpu, incoming), toward), step));
+    _mm256_store_ps(paddleY, _mm256_min_ps(_mm256_max_ps(py, _mm256_set1_ps(-PADDLE_MAX_Y)), _mm256_set1_ps(PADDLE_MAX_Y)));
+}
+
+TARGET_AVX2 static size_t stepAvx2(const BatchLanes& lanes, size_t count, uint32_t* scored)
+{
+    const auto zero = _mm256_setzero_ps();
+    const auto signBit = _mm256_set1_ps(-0.0f);
+    const auto dT = _mm256_set1_ps(World::dT);
+    const auto reach = _mm256_set1_ps(PADDLE_REACH);
+    const auto ballMax = _mm256_set1_ps(BALL_MAX_Y);
+    const auto faceX = _mm256_set1_ps(FACE_X);
+    const auto scoreX = _mm256_set1_ps(SCORE_X);
+    const auto cpu0 = _mm256_set1_ps(lanes.cpu[0]);
+    const auto cpu1 = _mm256_set1_ps(lanes.cpu[1]);
+    const auto paddleStep = _mm256_set1_ps(lanes.paddleStep);
+
+    size_t n = 0;
+    for (size_t i = 0; i < count; i += LANE_WIDTH)
+    {
+        auto bx = _mm256_load_ps(lanes.ballX + i);
+        auto by = _mm256_load_ps(lanes.ballY + i);
+        auto vx = _mm256_load_ps(lanes.ballVX + i);
+        auto vy = _mm256_load_ps(lanes.ballVY + i);
+
+        stepPaddleAvx2(lanes.paddleY[0] + i, cpu0, signAvx2(zero, vx), by, paddleStep);
+        stepPaddleAvx2(lanes.paddleY[1] + i, cpu1, signAvx2(vx, zero), by, paddleStep);
+
+        auto nx = _mm256_add_ps(bx, _mm256_mul_ps(vx, dT));
+        auto ny = _mm256_add_ps(by, _mm256_mul_ps(vy, dT));
+
+        auto below = _mm256_cmp_ps(ny, ballMax, _CMP_GT_OQ);
+        auto above = _mm256_cmp_ps(ny, _mm256_xor_ps(ballMax, signBit), _CMP_LT_OQ);
+        ny = _mm256_blendv_ps(ny, _mm256_sub_ps(_mm256_set1_ps(2.0f * BALL_MAX_Y), ny), below);
+        ny = _mm256_blendv_ps(ny, _mm256_sub_ps(_mm256_set1_ps(-2.0f * BALL_MAX_Y), ny), above);
+        vy = _mm256_xor_ps(vy, _mm256_and_ps(_mm256_or_ps(below, above), signBit));
+
+        auto rightY = _mm256_andnot_ps(signBit, _mm256_sub_ps(ny, _mm256_load_ps(lanes.paddleY[1] + i)));
+        auto leftY = _mm256_andnot_ps(signBit, _mm256_sub_ps(ny, _mm256_load_ps(lanes.paddleY[0] + i)));
+        auto hitRight = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(vx, zero, _CMP_GT_OQ), _mm256_cmp_ps(bx, faceX, _CMP_LE_OQ)),
+                                      _mm256_and_ps(_mm256_cmp_ps(nx, faceX, _CMP_GT_OQ), _mm256_cmp_ps(rightY, reach, _CMP_LT_OQ)));
+        auto leftFace = _mm256_xor_ps(faceX, signBit);
+        auto hitLeft = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(vx, zero, _CMP_LT_OQ), _mm256_cmp_ps(bx, leftFace, _CMP_GE_OQ)),
+                                     _mm256_and_ps(_mm256_cmp_ps(nx, leftFace, _CMP_LT_OQ), _mm256_cmp_ps(leftY, reach, _CMP_LT_OQ)));
+        nx = _mm256_blendv_ps(nx, _mm256_sub_ps(_mm256_set1_ps(2.0f * FACE_X), nx), hitRight);
+        nx = _mm256_blendv_ps(nx, _mm256_sub_ps(_mm256_set1_ps(-2.0f * FACE_X), nx), hitLeft);
+        vx = _mm256_xor_ps(vx, _mm256_and_ps(_mm256_or_ps(hitRight, hitLeft), signBit));
+
+        /* Masks are all ones, subtracting them counts a point */
+        auto rightWall = _mm256_cmp_ps(nx, scoreX, _CMP_GT_OQ);
+        auto leftWall = _mm256_cmp_ps(nx, _mm256_xor_ps(scoreX, signBit), _CMP_LT_OQ);
+        auto* scores0 = reinterpret_cast<__m256i*>(lanes.scores[0] + i);
+        auto* scores1 = reinterpret_cast<__m256i*>(lanes.scores[1] + i);
+        _mm256_store_si256(scores0, _mm256_sub_epi32(_mm256_load_si256(scores0), _mm256_castps_si256(rightWall)));
+        _mm256_store_si256(scores1, _mm256_sub_epi32(_mm256_load_si256(scores1), _mm256_castps_si256(leftWall)));
+        auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_or_ps(rightWall, leftWall)));
+        while (mask)
+        {
+            scored[n++] = i + lowestBit(mask);
+            mask &= mask - 1;
+        }
+
+        _mm256_store_ps(lanes.ballX + i, nx);
+        _mm256_store_ps(lanes.ballY + i, ny);
+        _mm256_store_ps(lanes.ballVX + i, vx);
+        _mm256_store_ps(lanes.ballVY + i, vy);
+    }
+    return n;
+}
+#endif
+
+struct BatchKernelTable
+{
+    BatchKernel kernels[2];
+    size_t count;
+};
+
+static BatchKernelTable detectBatchKernels()
+{
+    BatchKernelTable table {};
+    table.kernels[table.count++] = {"scalar", stepScalar};
+#ifdef SIMD_X86
+    if (cpuHasAvx2())
+    {
+        table.kernels[table.count++] = {"avx2", stepAvx2};
+    }
+#endif
+    return table;
+}
+
+const BatchKernel* batchKernels(size_t* count)
+{
+    static const BatchKernelTable table = detectBatchKernels();
+    *count = table.count;
+    return table.kernels;
+}
+
+/*** BatchSim ***********************************************************************/
+BatchSim::BatchSim(size_t lanes, uint64_t seed, Controller left, Controller right)
+    : BatchSim(lanes, Rng(seed), left, right)
+{
+}
+
+BatchSim::BatchSim(size_t lanes, const Rng& stream, Controller left, Controller right, float ballSpeed, float paddleSpeed)
+    : _lanes((lanes + LANE_WIDTH - 1) / LANE_WIDTH * LANE_WIDTH),
+      _ballX(_lanes),
+      _ballY(_lanes),
+      _ballVX(_lanes),
+      _ballVY(_lanes),
+      _paddleY {AlignedVector<float>(_lanes), AlignedVector<float>(_lanes)},
+      _scores {AlignedVector<int32_t>(_lanes), AlignedVector<int32_t>(_lanes)},
+      _scored(_lanes),
+      _scoredCount(0),
+      _servedAt(_lanes),
+      _controllers {left, right},
+      _skills {*findBotSkill("normal"), *findBotSkill("normal")},
+      _tables {nullptr, nullptr},
+      _external {nullptr, nullptr},
+      _points(0),
+      _ticks(0),
+      _ballSpeed(ballSpeed)
+{
+    for (int side = 0; side < 2; side++)
+    {
+        if (_controllers[side] == BOT)
+        {
+            _bots[side].resize(_lanes);
+        }
+        if (_controllers[side] == MLP)
+        {
+            _actions.resize(_lanes);
+        }
+        if (_controllers[side] == TABLE)
+        {
+            _cells.resize(_lanes);
+        }
+    }
+
+    _rngs.resize(_lanes);
+    _serves.reserve(_lanes);
+    restart(stream);
+
+    _view.ballX = _ballX.data();
+    _view.ballY = _ballY.data();
+    _view.ballVX = _ballVX.data();
+    _view.ballVY = _ballVY.data();
+    for (int side = 0; side < 2; side++)
+    {
+        _view.paddleY[side] = _paddleY[side].data();
+        _view.scores[side] = _scores[side].data();
+    }
+    _view.cpu[0] = left == CPU ? 1.0f : 0.0f;
+    _view.cpu[1] = right == CPU ? 1.0f : 0.0f;
+    _view.paddleStep = paddleSpeed * World::dT;
+
+    size_t kernelCount;
+    auto kernels = batchKernels(&kernelCount);
+    _kernel = kernels[kernelCount - 1];
+    auto mlps = mlpKernels(&kernelCount);
+    _mlpKernel = mlps[kernelCount - 1];
+}
+
+void BatchSim::tick()
+{
+    for (auto lane : _serves)
+    {
+        serve(lane);
+    }
+    _serves.clear();
+
+    for (int side = 0; side < 2; side++)
+    {
+        if (_controllers[side] == BOT)
+        {
+            stepBots(side);
+        }
+        else if (_controllers[side] == MLP)
+        {
+            stepMlp(side);
+        }
+        else if (_controllers[side] == TABLE && _tables[side])
+        {
+            stepTable(side);
+        }
+        else if (_controllers[side] == EXTERNAL && _external[side])
+        {
+            movePaddles(side, _external[side]);
+        }
+    }
+
+    _scoredCount = _kernel.run(_view, _lanes, _scored.data());
+    _points += _scoredCount;
+    _ticks++;
+    for (size_t i = 0; i < _scoredCount; i++)
+    {
+        reset(_scored[i]);
+    }
+}
+
+/* Same as World::reset(): the ball goes back to the center and waits for a serve */
+void BatchSim::reset(size_t lane)
+{
+    _ballX[lane] = 0.0f;
+    _ballY[lane] = 0.0f;
+    _ballVX[lane] = 0.0f;
+    _ballVY[lane] = 0.0f;
+    _serves.push_back(lane);
+}
+
+void BatchSim::restart(const Rng& stream)
+{
+    Rng rng = stream;
+    _serves.clear();
+    for (size_t i = 0; i < _lanes; i++)
+    {
+        _rngs[i] = rng;
+        rng.jump();
+        _servedAt[i] = 0;
+        for (int side = 0; side < 2; side++)
+        {
+            _paddleY[side][i] = 0.0f;
+            _scores[side][i] = 0;
+        }
+        reset(i);
+    }
+    for (auto& bots : _bots)
+    {
+        std::fill(bots.begin(), bots.end(), Bot());
+    }
+    _scoredCount = 0;
+    _points = 0;
+    _ticks = 0;
+}
+
+/* Kernel by name ("scalar", "avx2"), for the MLP paddles too, false if unknown or unsupported */
+bool BatchSim::setKernel(const char* name)
+{
+    size_t count;
+    auto mlps = mlpKernels(&count);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!strcmp(mlps[i].name, name))
+        {
+            _mlpKernel = mlps[i];
+        }
+    }
+
+    auto kernels = batchKernels(&count);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!strcmp(kernels[i].name, name))
+        {
+            _kernel = kernels[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+const BatchKernel& BatchSim::kernel() const
+{
+    return _kernel;
+}
+
+const MlpKernel& BatchSim::mlpKernel() const
+{
+    return _mlpKernel;
+}
+
+size_t BatchSim::lanes() const
+{
+    return _lanes;
+}
+
+const float* BatchSim::ballX() const
+{
+    return _ballX.data();
+}
+
+const float* BatchSim::ballY() const
+{
+    return _ballY.data();
+}
+
+const float* BatchSim::ballVX() const
+{
+    return _ballVX.data();
+}
+
+const float* BatchSim::ballVY() const
+{
+    return _ballVY.data();
+}
+
+const float* BatchSim::paddleY(int side) const
+{
+    return _paddleY[side].data();
+}
+
+const int32_t* BatchSim::scores(int side) const
+{
+    return _scores[side].data();
+}
+
+uint64_t BatchSim::points() const
+{
+    return _points;
+}
+
+const uint32_t* BatchSim::scored(size_t* count) const
+{
+    *count = _scoredCount;
+    return _scored.data();
+}
+
+uint32_t BatchSim::rallyTicks(size_t lane) const
+{
+    return static_cast<uint32_t>(_ticks - _servedAt[lane]);
+}
+
+void BatchSim::setSkill(int side, const BotSkill& skill)
+{
+    _skills[side] = skill;
+}
+
+void BatchSim::setPolicy(int side, const MlpPolicy& policy)
+{
+    _policies[side] = policy;
+}
+
+void BatchSim::setTable(int side, const PolicyTable* table)
+{
+    _tables[side] = table;
+}
+
+void BatchSim::setActions(int side, const float* actions)
+{
+    _external[side] = actions;
+}
+
+/* Moves the paddles of a BOT side the way the kernel moves CPU ones, before the ball */
+void BatchSim::stepBots(int side)
+{
+    auto bots = _bots[side].data();
+    auto rngs = _rngs.data();
+    auto paddleY = _paddleY[side].data();
+    const float* ballX = _ballX.data();
+    const float* ballY = _ballY.data();
+    const float* ballVX = _ballVX.data();
+    const float* ballVY = _ballVY.data();
+    const auto skill = _skills[side];
+    float x = side ? PADDLE_X : -PADDLE_X;
+    float step = _view.paddleStep;
+    for (size_t lane = 0; lane < _lanes; lane++)
+    {
+        auto dir = bots[lane].think(skill, {x, paddleY[lane]}, {ballX[lane], ballY[lane]}, {ballVX[lane], ballVY[lane]}, step, rngs[lane]);
+        paddleY[lane] = std::min(std::max(paddleY[lane] + (dir * step), -PADDLE_MAX_Y), PADDLE_MAX_Y);
+    }
+}
+
+/* The policy of an MLP side decides all the lanes at once, then the paddles move like BOT ones */
+void BatchSim::stepMlp(int side)
+{
+    MlpInputs inputs {_ballX.data(), _ballY.data(), _ballVX.data(), _ballVY.data(), _paddleY[side].data(), side ? 1.0f : -1.0f};
+    _mlpKernel.run(_policies[side], inputs, _lanes, _actions.data());
+    movePaddles(side, _actions.data());
+}
+
+/* Moves the paddles of a side by a fraction of their speed per lane, clamped to [-1, 1] (NaN to -1) */
+void BatchSim::movePaddles(int side, const float* actions)
+{
+    auto paddleY = _paddleY[side].data();
+    float step = _view.paddleStep;
+    for (size_t lane = 0; lane < _lanes; lane++)
+    {
+        float action = std::min(1.0f, std::max(-1.0f, actions[lane]));
+        paddleY[lane] = std::min(std::max(paddleY[lane] + (action * step), -PADDLE_MAX_Y), PADDLE_MAX_Y);
+    }
+}
+
+/* The cells of all the lanes, then one load per lane from the table of the side */
+void BatchSim::stepTable(int side)
+{
+    auto paddleY = _paddleY[side].data();
+    const uint32_t* cells = _cells.data();
+    PolicyTable::cells(_ballX.data(), _ballY.data(), _ballVX.data(), _ballVY.data(), paddleY, side ? 1.0f : -1.0f, _lanes, _cells.data());
+
+    const uint8_t* packed = _tables[side]->packed();
+    float step = _view.paddleStep;
+    for (size_t lane = 0; lane < _lanes; lane++)
+    {
+        float action = static_cast<float>(PolicyTable::action(packed, cells[lane]));
+        paddleY[lane] = std::min(std::max(paddleY[lane] + (action * step), -PADDLE_MAX_Y), PADDLE_MAX_Y);
+    }
+}
+
+/* Same draw as the SERVE control of World */
+void BatchSim::serve(size_t lane)
+{
+    auto& rng = _rngs[lane];
+    _servedAt[lane] = _ticks;
+    glm::vec2 v;
+    do
+    {
+        v = glm::vec2 {(rng.fnext() * 2.0f) - 1.0f, (rng.fnext() * 2.0f) - 1.0f};
+    } while (v.x < 0.01f);
+    v = glm::normalize(v) * _ballSpeed;
+    _ballVX[lane] = v.x;
+    _ballVY[lane] = v.y;
+}
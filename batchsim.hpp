@@ -0,0 +1,140 @@
+#pragma once
+
+#include "aligned.hpp"
+#include "bot.hpp"
+#include "mlp.hpp"
+#include "policytable.hpp"
+#include "rng.hpp"
+#include "rules.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Pointers to the lanes of a BatchSim, as seen by the step kernels. Every
+ * array holds one value per lane.
+ */
+struct BatchLanes
+{
+    float* ballX;
+    float* ballY;
+    float* ballVX;
+    float* ballVY;
+    float* paddleY[2];
+    int32_t* scores[2];
+    float cpu[2];     /* 1 for a CPU paddle, 0 for the others */
+    float paddleStep; /* distance a paddle moves in a tick */
+};
+
+/*
+ * Advances count lanes (a multiple of 8) by one tick. Writes the index of
+ * every lane where a point was scored to scored and returns how many there
+ * are; scored must have room for count entries.
+ */
+using BatchKernelFn = size_t (*)(const BatchLanes& lanes, size_t count, uint32_t* scored);
+
+struct BatchKernel
+{
+    const char* name;
+    BatchKernelFn run;
+};
+
+/* Kernels usable on this CPU, fastest last. The scalar kernel is always first. */
+const BatchKernel* batchKernels(size_t* count);
+
+/*
+ * Many independent matches stepped together, one per lane, for statistics
+ * and AI tuning.
+ *
+ * Each lane holds a ball, two paddles, the scores and its own Rng, stored as
+ * structure of arrays so that a tick is a handful of SIMD instructions per 8
+ * lanes. The rules are those of World, made branch-free: the paddles chase
+ * the ball like the CPU paddle of FixedWorld, stay idle, are played by one
+ * Bot per lane, an MlpPolicy over all the lanes or a PolicyTable, or follow
+ * actions from outside, all stepped before the kernel. The ball is reflected
+ * off the bounce walls and the paddle faces, and a ball reaching a score
+ * wall resets its lane the way World::reset() does. The ball does not bounce
+ * off the ends of the paddles.
+ *
+ * Like a headless World, an idle ball is served at the start of the next tick.
+ *
+ * Lane i draws from stream after i jumps, so a BatchSim built from a stream
+ * owns 2^128 * lanes draws of it. Ball and paddle speeds default to the rules
+ * and can be changed to sweep them.
+ */
+class BatchSim
+{
+public:
+    enum Controller : uint8_t
+    {
+        IDLE,
+        CPU,
+        BOT,
+        MLP,
+        TABLE,
+        EXTERNAL,
+    };
+
+    BatchSim(size_t lanes, uint64_t seed, Controller left, Controller right);
+    BatchSim(size_t lanes,
+             const Rng& stream,
+             Controller left,
+             Controller right,
+             float ballSpeed = BALL_SPEED,
+             float paddleSpeed = PADDLE_SPEED);
+    void tick();
+    void reset(size_t lane);
+    void restart(const Rng& stream); /* every lane back to 0-0 drawing from stream, without allocating */
+    void setSkill(int side, const BotSkill& skill);    /* of a BOT side, normal by default */
+    void setPolicy(int side, const MlpPolicy& policy); /* of an MLP side, still by default */
+    void setTable(int side, const PolicyTable* table);  /* of a TABLE side, mapped, still when null */
+    void setActions(int side, const float* actions);    /* of an EXTERNAL side, one per lane in [-1, 1], read by every tick */
+    bool setKernel(const char* name);
+    const BatchKernel& kernel() const;
+    const MlpKernel& mlpKernel() const;
+
+    size_t lanes() const;
+    const float* ballX() const;
+    const float* ballY() const;
+    const float* ballVX() const;
+    const float* ballVY() const;
+    const float* paddleY(int side) const;
+    const int32_t* scores(int side) const;
+    uint64_t points() const; /* scored since construction, all lanes together */
+    const uint32_t* scored(size_t* count) const; /* lanes where a point was scored by the last tick */
+    uint32_t rallyTicks(size_t lane) const;       /* since the last serve of the lane */
+
+private:
+    size_t _lanes;
+    AlignedVector<float> _ballX;
+    AlignedVector<float> _ballY;
+    AlignedVector<float> _ballVX;
+    AlignedVector<float> _ballVY;
+    AlignedVector<float> _paddleY[2];
+    AlignedVector<int32_t> _scores[2];
+    std::vector<Rng> _rngs;
+    std::vector<uint32_t> _scored;
+    size_t _scoredCount;
+    std::vector<uint32_t> _servedAt; /* tick of the last serve of each lane */
+    std::vector<uint32_t> _serves; /* idle lanes to serve at the next tick */
+    Controller _controllers[2];
+    std::vector<Bot> _bots[2];
+    BotSkill _skills[2];
+    MlpPolicy _policies[2];
+    const PolicyTable* _tables[2];
+    const float* _external[2];
+    AlignedVector<float> _actions;  /* of the MLP sides, sized when there is one */
+    AlignedVector<uint32_t> _cells; /* of the TABLE sides, same */
+    BatchLanes _view;
+    BatchKernel _kernel;
+    MlpKernel _mlpKernel;
+    uint64_t _points;
+    uint32_t _ticks;
+    float _ballSpeed;
+
+    void serve(size_t lane);
+    void stepBots(int side);
+    void stepMlp(int side);
+    void stepTable(int side);
+    void movePaddles(int side, const float* actions);
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cmath>
+#include <glm/glm.hpp>
+#include <stdint.h>
+
+/*
+ * Per-entity behavior, replacing the std::function callbacks.
+ *
+ * The set of kinds is closed, so collision responses are dispatched with a
+ * plain switch that the compiler can inline into the collision loop. The
+ * payload is a couple of bytes stored next to the entity, never on the heap.
+ */
+struct Behavior
+{
+    enum Kind : uint8_t
+    {
+        NONE,
+        SCORE_WALL,
+        BOUNCE_WALL,
+        PADDLE,
+        BALL,
+    };
+
+    enum Control : uint8_t
+    {
+        STATIC,
+        SERVE,
+        KEYBOARD,
+        CPU, /* chases the ball */
+        BOT, /* plays a Bot */
+        MLP,   /* plays the MlpPolicy of the World */
+        TABLE, /* plays the PolicyTable of the World */
+    };
+
+    Kind kind;
+    Control control;
+    uint8_t player; /* player credited when the ball reaches a SCORE_WALL, or controlling a KEYBOARD or computer paddle */
+};
+
+/* What happened during a collision response, for the caller to turn into side effects (score, sounds) */
+enum class CollisionEvent
+{
+    NONE,
+    WALL_BOUNCE,
+    PADDLE_BOUNCE,
+    SCORE,
+};
+
+/*
+ * Accumulated effect of all the contacts of one body during a tick.
+ *
+ * Contacts are resolved in a batch: responses only accumulate here and the
+ * result is applied once every contact has been seen. Both accumulations are
+ * commutative (largest push per axis, union of reflections), so the outcome
+ * does not depend on the order of the contacts.
+ */
+struct Resolution
+{
+    static constexpr uint8_t REFLECT_X = 1;
+    static constexpr uint8_t REFLECT_Y = 2;
+
+    glm::vec2 push;
+    uint8_t reflect;
+
+    void addPush(glm::vec2 pv)
+    {
+        push.x = largest(push.x, pv.x);
+        push.y = largest(push.y, pv.y);
+    }
+
+    void addBounce(glm::vec2 pv)
+    {
+        addPush(pv);
+        if (pv.x < 0.0f || pv.x > 0.0f) /* horizontal collision */
+        {
+            reflect |= REFLECT_X;
+        }
+        if (pv.y < 0.0f || pv.y > 0.0f) /* vertical collision */
+        {
+            reflect |= REFLECT_Y;
+        }
+    }
+
+    void apply(glm::vec2& pos, glm::vec2& v) const
+    {
+        pos += push;
+        if (reflect & REFLECT_X)
+        {
+            v.x = -v.x;
+        }
+        if (reflect & REFLECT_Y)
+        {
+            v.y = -v.y;
+        }
+    }
+
+private:
+    /* Larger magnitude wins, ties go to the larger value, so that any order gives the same result */
+    static float largest(float a, float b)
+    {
+        float aa = std::fabs(a);
+        float ab = std::fabs(b);
+        return (aa > ab || (aa == ab && a > b)) ? a : b;
+    }
+};
+
+/*
+ * Response of self to a contact with other, pv being the penetration vector
+ * from self towards other. Called once for each side of every contact.
+ */
+inline CollisionEvent respond(Behavior self, Behavior other, Resolution& selfResolution, Resolution& otherResolution, glm::vec2 pv)
+{
+    switch (self.kind)
+    {
+    case Behavior::SCORE_WALL:
+        if (other.kind == Behavior::BALL)
+        {
+            return CollisionEvent::SCORE;
+        }
+        break;
+    case Behavior::BOUNCE_WALL:
+        if (other.kind == Behavior::BALL)
+        {
+            otherResolution.addBounce(pv);
+            return CollisionEvent::WALL_BOUNCE;
+        }
+        break;
+    case Behavior::PADDLE:
+        if (other.kind == Behavior::BALL)
+        {
+            otherResolution.addBounce(pv);
+            return CollisionEvent::PADDLE_BOUNCE;
+        }
+        else /* assume wall */
+        {
+            selfResolution.addPush(-pv);
+        }
+        break;
+    case Behavior::NONE:
+    case Behavior::BALL:
+        break;
+    }
+    return CollisionEvent::NONE;
+}
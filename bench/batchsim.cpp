@@ -0,0 +1,52 @@
+/*
+ * Match-ticks per second of each BatchSim kernel supported by this CPU, on a
+ * single core, with a check that every kernel leaves the lanes in the same
+ * state as the scalar one.
+ */
+#include "batchsim.hpp"
+#include "bench.hpp"
+#include <algorithm>
+#include <fmt/format.h>
+#include <string.h>
+
+static bool sameState(const BatchSim& a, const BatchSim& b)
+{
+    auto bytes = a.lanes() * sizeof(float);
+    return !memcmp(a.ballX(), b.ballX(), bytes) && !memcmp(a.ballY(), b.ballY(), bytes) && !memcmp(a.ballVX(), b.ballVX(), bytes) &&
+           !memcmp(a.ballVY(), b.ballVY(), bytes) && !memcmp(a.paddleY(0), b.paddleY(0), bytes) && !memcmp(a.paddleY(1), b.paddleY(1), bytes) &&
+           !memcmp(a.scores(0), b.scores(0), bytes) && !memcmp(a.scores(1), b.scores(1), bytes);
+}
+
+int main()
+{
+    static constexpr size_t TICKS = 1000;
+
+    size_t kernelCount;
+    auto kernels = batchKernels(&kernelCount);
+
+    fmt::println("{:>8} {:>8} {:>14} {:>12} {:>8}", "kernel", "lanes", "Mticks/s", "points", "check");
+    for (size_t lanes : {64, 1024, 16384, 262144})
+    {
+        BatchSim reference(lanes, 1, BatchSim::IDLE, BatchSim::CPU);
+        reference.setKernel("scalar");
+        for (size_t t = 0; t < TICKS; t++)
+        {
+            reference.tick();
+        }
+
+        for (size_t k = 0; k < kernelCount; k++)
+        {
+            BatchSim sim(lanes, 1, BatchSim::IDLE, BatchSim::CPU);
+            sim.setKernel(kernels[k].name);
+            for (size_t t = 0; t < TICKS; t++)
+            {
+                sim.tick();
+            }
+            bool same = sameState(sim, reference);
+
+            auto ns = measure(std::max<size_t>(1, 1000000 / lanes), [&]() { sim.tick(); });
+            fmt::println("{:>8} {:>8} {:>14.1f} {:>12} {:>8}", kernels[k].name, lanes, lanes / ns * 1000.0, sim.points(), same ? "ok" : "MISMATCH");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <stddef.h>
+
+/*
+ * Runs f() `iterations` times, `rounds` times over, and returns the best
+ * average duration of a single call in nanoseconds.
+ */
+template <typename F>
+double measure(size_t iterations, F&& f, int rounds = 5)
+{
+    double best = 0.0;
+    for (int round = 0; round < rounds; round++)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            f();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / iterations;
+        if (round == 0 || ns < best)
+        {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+/* Keeps the optimizer from discarding a computed value */
+template <typename T>
+void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
@@ -0,0 +1,104 @@
+/*
+ * Predictive bots: accuracy of the analytic intercept, cost of a bot next to
+ * the kernel of a BatchSim tick, and how each skill fares against the
+ * chasing CPU paddle.
+ *
+ * The intercept is checked against a ball stepped in small increments between
+ * the walls, in double so the stepping itself does not drift, with a tolerance
+ * of one step.
+ */
+#include "batchsim.hpp"
+#include "bench.hpp"
+#include "bot.hpp"
+#include "rules.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fmt/format.h>
+
+static constexpr float BALL_MAX_Y = (GAME_HEIGHT - BALL_SIZE) / 2.0f;
+static constexpr float FACE_X = ((GAME_WIDTH / 2.0f) - PADDLE_INSET) - ((PADDLE_WIDTH + BALL_SIZE) / 2.0f);
+
+/* Where the ball crosses x, stepped 1/10000 of the way at a time */
+static float steppedY(glm::vec2 pos, glm::vec2 v, float x)
+{
+    static constexpr int STEPS = 10000;
+    double y = pos.y;
+    double dy = static_cast<double>(v.y) * ((static_cast<double>(x) - pos.x) / v.x / STEPS);
+    for (int i = 0; i < STEPS; i++)
+    {
+        y += dy;
+        if (std::abs(y) > BALL_MAX_Y)
+        {
+            y = std::copysign(2.0 * BALL_MAX_Y, y) - y;
+            dy = -dy;
+        }
+    }
+    return static_cast<float>(y);
+}
+
+int main()
+{
+    static constexpr size_t LANES = 16384;
+    static constexpr size_t TICKS = 60 * 60 * 10; /* ten minutes of play */
+
+    Rng rng(1);
+    float maxError = 0.0f;
+    bool ok = true;
+    for (int i = 0; i < 1000; i++)
+    {
+        glm::vec2 pos {((rng.fnext() * 2.0f) - 1.0f) * FACE_X, ((rng.fnext() * 2.0f) - 1.0f) * BALL_MAX_Y};
+        glm::vec2 v {0.05f + rng.fnext(), ((rng.fnext() * 2.0f) - 1.0f) * 4.0f};
+        float predicted = interceptY(pos, v, FACE_X);
+        float stepped = steppedY(pos, v, FACE_X);
+        float error = std::abs(predicted - stepped);
+        maxError = std::max(maxError, error);
+        ok = ok && error <= std::abs(v.y * ((FACE_X - pos.x) / v.x)) / 10000.0f + 1e-4f;
+    }
+    fmt::println("intercept: max error {:.2e} over 1000 courses, {}", maxError, ok ? "ok" : "MISMATCH");
+    glm::vec2 pos {0.0f, 0.0f};
+    glm::vec2 v {0.6f, 0.45f};
+    auto interceptNs = measure(1000000,
+                               [&]()
+                               {
+                                   doNotOptimize(interceptY(pos, v, FACE_X));
+                                   pos.y = pos.y > 0.4f ? -0.4f : pos.y + 0.001f;
+                               });
+    fmt::println("intercept: {:.1f} ns", interceptNs);
+    fmt::println("");
+
+    fmt::println("{:>8} {:>12} {:>12}", "paddles", "ns/lane", "Mticks/s");
+    for (auto controller : {BatchSim::CPU, BatchSim::BOT})
+    {
+        BatchSim sim(LANES, 1, controller, controller);
+        auto ns = measure(100, [&]() { sim.tick(); });
+        fmt::println("{:>8} {:>12.2f} {:>12.1f}", controller == BatchSim::CPU ? "cpu" : "bot", ns / LANES, LANES / ns * 1000.0);
+    }
+    fmt::println("");
+
+    size_t skillCount;
+    auto skills = botSkills(&skillCount);
+    fmt::println("{:>8} {:>10} {:>12} {:>12} {:>10}", "bot", "reaction", "error", "points won", "share");
+    for (size_t s = 0; s < skillCount; s++)
+    {
+        BatchSim sim(LANES / 16, 1, BatchSim::BOT, BatchSim::CPU);
+        sim.setSkill(0, skills[s]);
+        for (size_t t = 0; t < TICKS; t++)
+        {
+            sim.tick();
+        }
+        uint64_t won = 0;
+        uint64_t lost = 0;
+        for (size_t lane = 0; lane < sim.lanes(); lane++)
+        {
+            won += sim.scores(0)[lane];
+            lost += sim.scores(1)[lane];
+        }
+        fmt::println("{:>8} {:>10} {:>12.2f} {:>12} {:>9.1f}%",
+                     skills[s].name,
+                     skills[s].reactionTicks,
+                     skills[s].error,
+                     won,
+                     won + lost ? 100.0 * won / (won + lost) : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * Candidate pair counts and time per tick of each broadphase backend as the
+ * number of balls grows. Balls shrink as their number grows so that the
+ * playfield density stays playable.
+ */
+#include "bench.hpp"
+#include "broadphase.hpp"
+#include "rng.hpp"
+#include "rules.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fmt/format.h>
+#include <vector>
+
+static constexpr auto dT = 1.0f / 60.0f;
+
+struct Scene
+{
+    std::vector<glm::vec2> pos;
+    std::vector<glm::vec2> size;
+    std::vector<glm::vec2> v;
+    std::vector<uint32_t> bodies;
+    size_t firstBall;
+};
+
+static Scene makeScene(size_t balls)
+{
+    Scene scene;
+    auto add = [&scene](glm::vec2 pos, glm::vec2 size, glm::vec2 v)
+    {
+        scene.bodies.push_back(scene.pos.size());
+        scene.pos.push_back(pos);
+        scene.size.push_back(size);
+        scene.v.push_back(v);
+    };
+
+    /* walls and paddles, laid out as in App::onInit */
+    add({-GAME_WIDTH / 2.0f - WALL_THICKNESS / 2.0f, 0.0f}, {WALL_THICKNESS, GAME_HEIGHT + WALL_THICKNESS * 2.0f}, {});
+    add({GAME_WIDTH / 2.0f + WALL_THICKNESS / 2.0f, 0.0f}, {WALL_THICKNESS, GAME_HEIGHT + WALL_THICKNESS * 2.0f}, {});
+    add({0.0f, -GAME_HEIGHT / 2.0f - WALL_THICKNESS / 2.0f}, {GAME_WIDTH, WALL_THICKNESS}, {});
+    add({0.0f, GAME_HEIGHT / 2.0f + WALL_THICKNESS / 2.0f}, {GAME_WIDTH, WALL_THICKNESS}, {});
+    add({-GAME_WIDTH / 2.0f + PADDLE_INSET, 0.0f}, {PADDLE_WIDTH, PADDLE_HEIGHT}, {});
+    add({GAME_WIDTH / 2.0f - PADDLE_INSET, 0.0f}, {PADDLE_WIDTH, PADDLE_HEIGHT}, {});
+    scene.firstBall = scene.pos.size();
+
+    Rng rng(1234);
+    auto ballSize = std::min(BALL_SIZE, 0.5f * std::sqrt(GAME_WIDTH * GAME_HEIGHT / balls));
+    for (size_t i = 0; i < balls; i++)
+    {
+        glm::vec2 pos {(rng.fnext() - 0.5f) * GAME_WIDTH, (rng.fnext() - 0.5f) * GAME_HEIGHT};
+        glm::vec2 v {(rng.fnext() - 0.5f) * 1.5f, (rng.fnext() - 0.5f) * 1.5f};
+        add(pos, {ballSize, ballSize}, v);
+    }
+    return scene;
+}
+
+/* Moves the balls, reflecting them on the playfield bounds */
+static void step(Scene& scene)
+{
+    for (size_t i = scene.firstBall; i < scene.pos.size(); i++)
+    {
+        auto& pos = scene.pos[i];
+        auto& v = scene.v[i];
+        pos += v * dT;
+        if (std::abs(pos.x) > GAME_WIDTH / 2.0f)
+        {
+            v.x = -v.x;
+        }
+        if (std::abs(pos.y) > GAME_HEIGHT / 2.0f)
+        {
+            v.y = -v.y;
+        }
+    }
+}
+
+static size_t countOverlaps(const Scene& scene, const ArenaVector<BodyPair>& pairs)
+{
+    size_t overlaps = 0;
+    for (auto pair : pairs)
+    {
+        auto d = glm::abs(scene.pos[pair.b] - scene.pos[pair.a]);
+        auto extent = (scene.size[pair.a] + scene.size[pair.b]) / 2.0f;
+        overlaps += d.x < extent.x && d.y < extent.y;
+    }
+    return overlaps;
+}
+
+int main()
+{
+    static constexpr size_t TICKS = 60;
+
+    fmt::println("{:>8} {:>8} {:>14} {:>12} {:>12}", "backend", "bodies", "candidates", "overlaps", "us/tick");
+    for (size_t balls : {16, 64, 256, 1024, 4096, 16384})
+    {
+        auto ballSize = std::min(BALL_SIZE, 0.5f * std::sqrt(GAME_WIDTH * GAME_HEIGHT / balls));
+
+        std::unique_ptr<Broadphase> backends[] = {
+            balls <= 4096 ? std::make_unique<BruteForceBroadphase>() : nullptr,
+            std::make_unique<GridBroadphase>(glm::vec2 {-1.0f, -0.6f}, glm::vec2 {1.0f, 0.6f}, ballSize * 3.0f),
+            std::make_unique<SweepAndPruneBroadphase>(),
+        };
+
+        for (auto& backend : backends)
+        {
+            if (!backend)
+            {
+                continue;
+            }
+
+            auto scene = makeScene(balls);
+            Arena arena(1024 * 1024);
+            size_t candidates = 0;
+            size_t overlaps = 0;
+            auto ns = measure(
+                TICKS,
+                [&]()
+                {
+                    arena.reset();
+                    step(scene);
+                    ArenaVector<BodyPair> pairs {ArenaAllocator<BodyPair>(&arena)};
+                    backend->findPairs(scene.bodies.data(), scene.bodies.size(), scene.pos.data(), scene.size.data(), pairs);
+                    candidates = pairs.size();
+                    overlaps = countOverlaps(scene, pairs);
+                },
+                3);
+
+            fmt::println("{:>8} {:>8} {:>14} {:>12} {:>12.1f}", backend->name(), scene.bodies.size(), candidates, overlaps, ns / 1000.0);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+/*
+ * Compares the old per-entity std::function collision callbacks with the
+ * static Behavior dispatch, at a few thousand to a few tens of thousand
+ * collision events per tick. The static path includes applying the
+ * accumulated resolutions at the end of the tick.
+ */
+#include "behavior.hpp"
+#include "bench.hpp"
+#include "rng.hpp"
+#include <fmt/format.h>
+#include <functional>
+#include <vector>
+
+struct Event
+{
+    uint32_t self;
+    uint32_t other;
+    glm::vec2 pv;
+};
+
+struct World
+{
+    std::vector<glm::vec2> pos;
+    std::vector<glm::vec2> v;
+    std::vector<Behavior> behavior;
+    int scores[2];
+    int sounds;
+};
+
+static World makeWorld(size_t balls)
+{
+    World world {};
+    auto add = [&world](Behavior behavior)
+    {
+        world.pos.push_back({0.0f, 0.0f});
+        world.v.push_back({0.5f, 0.5f});
+        world.behavior.push_back(behavior);
+    };
+    add({Behavior::SCORE_WALL, Behavior::STATIC, 1});
+    add({Behavior::SCORE_WALL, Behavior::STATIC, 0});
+    add({Behavior::BOUNCE_WALL, Behavior::STATIC});
+    add({Behavior::BOUNCE_WALL, Behavior::STATIC});
+    add({Behavior::PADDLE, Behavior::KEYBOARD});
+    add({Behavior::PADDLE, Behavior::CPU});
+    for (size_t i = 0; i < balls; i++)
+    {
+        add({Behavior::BALL, Behavior::SERVE});
+    }
+    return world;
+}
+
+/* Walls and paddles hitting balls, with the occasional paddle against wall contact */
+static std::vector<Event> makeEvents(const World& world, size_t count)
+{
+    static constexpr uint32_t STATICS = 6;
+    Rng rng(42);
+    std::vector<Event> events;
+    for (size_t i = 0; i < count; i++)
+    {
+        Event e;
+        e.self = rng.next() % STATICS;
+        if (rng.next() % 16)
+        {
+            e.other = STATICS + rng.next() % (world.pos.size() - STATICS);
+        }
+        else
+        {
+            do
+            {
+                e.other = rng.next() % STATICS;
+            } while (e.other == e.self);
+        }
+        e.pv = rng.next() & 1 ? glm::vec2 {(rng.fnext() - 0.5f) * 0.01f, 0.0f} : glm::vec2 {0.0f, (rng.fnext() - 0.5f) * 0.01f};
+        events.push_back(e);
+    }
+    return events;
+}
+
+/* Mirrors the lambdas App::onInit used to install */
+static void bounce(glm::vec2& ballPos, glm::vec2& ballV, glm::vec2 pv)
+{
+    ballPos += pv;
+    if (pv.x < 0.0f || pv.x > 0.0f) /* horizontal collision */
+    {
+        ballV.x = -ballV.x;
+    }
+    if (pv.y < 0.0f || pv.y > 0.0f) /* vertical collision */
+    {
+        ballV.y = -ballV.y;
+    }
+}
+
+using Callback = std::function<void(uint32_t self, uint32_t other, glm::vec2 pv)>;
+
+static std::vector<Callback> makeCallbacks(World& world)
+{
+    auto bounceBall = [&world](uint32_t ball, glm::vec2 pv)
+    {
+        bounce(world.pos[ball], world.v[ball], pv);
+    };
+
+    std::vector<Callback> callbacks(world.pos.size());
+    for (size_t i = 0; i < world.pos.size(); i++)
+    {
+        switch (world.behavior[i].kind)
+        {
+        case Behavior::SCORE_WALL:
+        {
+            int player = world.behavior[i].player;
+            callbacks[i] = [&world, player](uint32_t self, uint32_t other, glm::vec2 pv)
+            {
+                if (world.behavior[other].kind == Behavior::BALL)
+                {
+                    world.scores[player]++;
+                    world.sounds++;
+                }
+            };
+        }
+        break;
+        case Behavior::BOUNCE_WALL:
+            callbacks[i] = [&world, bounceBall](uint32_t self, uint32_t other, glm::vec2 pv)
+            {
+                if (world.behavior[other].kind == Behavior::BALL)
+                {
+                    bounceBall(other, pv);
+                }
+            };
+            break;
+        case Behavior::PADDLE:
+            callbacks[i] = [&world, bounceBall](uint32_t self, uint32_t other, glm::vec2 pv)
+            {
+                if (world.behavior[other].kind == Behavior::BALL)
+                {
+                    bounceBall(other, pv);
+                    world.sounds++;
+                }
+                else
+                {
+                    world.pos[self] += -pv;
+                }
+            };
+            break;
+        case Behavior::NONE:
+        case Behavior::BALL:
+            break;
+        }
+    }
+    return callbacks;
+}
+
+static void runFunction(World& world, const std::vector<Callback>& callbacks, const std::vector<Event>& events)
+{
+    for (const auto& e : events)
+    {
+        const auto& callback = callbacks[e.self];
+        if (callback)
+        {
+            callback(e.self, e.other, e.pv);
+        }
+    }
+}
+
+static void runStatic(World& world, std::vector<Resolution>& resolutions, const std::vector<Event>& events)
+{
+    auto behavior = world.behavior.data();
+    auto resolution = resolutions.data();
+    for (const auto& e : events)
+    {
+        switch (respond(behavior[e.self], behavior[e.other], resolution[e.self], resolution[e.other], e.pv))
+        {
+        case CollisionEvent::NONE:
+        case CollisionEvent::WALL_BOUNCE:
+            break;
+        case CollisionEvent::PADDLE_BOUNCE:
+            world.sounds++;
+            break;
+        case CollisionEvent::SCORE:
+            world.scores[behavior[e.self].player]++;
+            world.sounds++;
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < world.pos.size(); i++)
+    {
+        resolution[i].apply(world.pos[i], world.v[i]);
+        resolution[i] = {};
+    }
+}
+
+int main()
+{
+    fmt::println("{:>8} {:>8} {:>14} {:>14} {:>8}", "balls", "events", "function ns/ev", "static ns/ev", "speedup");
+    for (size_t balls : {16, 1024, 16384})
+    {
+        for (size_t count : {10000, 50000})
+        {
+            auto world = makeWorld(balls);
+            auto events = makeEvents(world, count);
+            auto callbacks = makeCallbacks(world);
+            std::vector<Resolution> resolutions(world.pos.size());
+
+            auto tFunction = measure(100, [&]()
+                                     {
+                                         runFunction(world, callbacks, events);
+                                         doNotOptimize(world.sounds);
+                                     });
+            auto tStatic = measure(100, [&]()
+                                   {
+                                       runStatic(world, resolutions, events);
+                                       doNotOptimize(world.sounds);
+                                   });
+
+            fmt::println("{:>8} {:>8} {:>14.2f} {:>14.2f} {:>7.2f}x", balls, count, tFunction / count, tStatic / count, tFunction / tStatic);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * Vectorized environment library: cost of env_step() through the C ABI for
+ * growing numbers of matches, with an agent following the ball read straight
+ * from the observation arrays, and a check that stepping does not allocate.
+ */
+#include "alloccount.hpp"
+#include "bench.hpp"
+#include "env.h"
+#include <fmt/format.h>
+#include <vector>
+
+static constexpr size_t STEPS = 60 * 60;
+
+/* Moves towards the ball, the way a script driving the library would */
+static void follow(const PongEnv* env, float* actions)
+{
+    auto ballY = env_observation(env, PONG_ENV_BALL_Y);
+    auto paddleY = env_observation(env, PONG_ENV_PADDLE_Y);
+    size_t n = env_size(env);
+    for (size_t i = 0; i < n; i++)
+    {
+        actions[i] = (ballY[i] - paddleY[i]) * 20.0f;
+    }
+}
+
+int main()
+{
+    fmt::println("{:>8} {:>12} {:>12} {:>12}", "envs", "us/step", "ns/env", "Msteps/s");
+    for (size_t n : {1, 64, 4096, 65536})
+    {
+        auto env = env_create(n);
+        std::vector<float> actions(env_size(env));
+        auto ns = measure(n >= 4096 ? 200 : 10000, [&]() {
+            follow(env, actions.data());
+            env_step(env, actions.data());
+        });
+        fmt::println("{:>8} {:>12.2f} {:>12.2f} {:>12.1f}", env_size(env), ns / 1000.0, ns / env_size(env), env_size(env) / ns * 1000.0);
+        env_destroy(env);
+    }
+    fmt::println("");
+
+    /* A minute of play against each opponent, counting the allocations of the steps */
+    fmt::println("{:>8} {:>10} {:>10} {:>12}", "opponent", "points", "reward", "allocations");
+    for (auto opponent : {"idle", "cpu", "easy", "normal", "hard", "perfect"})
+    {
+        auto env = env_create_opponent(4096, opponent);
+        size_t n = env_size(env);
+        std::vector<float> actions(n);
+        auto rewards = env_rewards(env);
+        auto dones = env_dones(env);
+        env_reset(env, 12345);
+
+        double points = 0.0;
+        double reward = 0.0;
+        size_t before = allocationCount();
+        for (size_t t = 0; t < STEPS; t++)
+        {
+            follow(env, actions.data());
+            env_step(env, actions.data());
+            for (size_t i = 0; i < n; i++)
+            {
+                points += dones[i];
+                reward += rewards[i];
+            }
+        }
+        size_t allocations = allocationCount() - before;
+        fmt::println("{:>8} {:>10.2f} {:>10.2f} {:>12}", opponent, points / n, reward / n, allocations);
+        env_destroy(env);
+        if (allocations)
+        {
+            fmt::println(stderr, "env_step() allocated");
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * Throughput of the event-driven match simulator: simulated seconds per wall
+ * clock second, and how many fixed FPS ticks that stands for.
+ *
+ * Also checks it against the fixed step World: the first point must be scored
+ * by the same player during the same tick, with the ball following the same
+ * path until then. With idle paddles only the rare balls trapped between a
+ * paddle and a score wall differ, with a CPU paddle the way it dithers around
+ * the ball in World makes more rallies differ, so only the idle case has to
+ * reach MIN_IDLE_SAME, or the benchmark fails. The threshold leaves room for
+ * float code generation (FMA contraction, another libm) to move a few
+ * trapped balls; dropping the bounce skin alone loses about a hundred.
+ */
+#include "eventsim.hpp"
+#include "world.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fmt/format.h>
+
+static constexpr auto TOLERANCE = 0.001;   /* ball distance above which paths differ */
+static constexpr auto RALLIES = 1000;      /* compared per right paddle */
+static constexpr auto MIN_IDLE_SAME = 980; /* identical first points out of RALLIES with idle paddles, 995 here */
+
+struct Comparison
+{
+    bool same;       /* same scorer during the same tick, or no point at all */
+    double maxError; /* largest distance between the two balls */
+};
+
+static Comparison compare(uint64_t seed, EventSim::Controller right)
+{
+    static constexpr auto MAX_TICKS = 60 * World::FPS;
+
+    World world;
+    world.init(seed);
+    EventSim sim(seed, EventSim::IDLE, right); /* the keyboard paddle gets no input */
+    auto& entities = world.entities();
+    for (size_t i = 0; i < entities.count(); i++)
+    {
+        if (entities.behavior()[i].control == Behavior::BOT)
+        {
+            entities.behavior()[i].control = right == EventSim::IDLE ? Behavior::STATIC : Behavior::CPU;
+        }
+    }
+    Keystate input {};
+    input.space = true;
+
+    Comparison result {false, 0.0};
+    for (int tick = 0; tick < MAX_TICKS; tick++)
+    {
+        auto events = world.tick(input);
+        sim.advance(World::dT);
+
+        const auto& state = sim.state();
+        int simScorer = state.scores[0] ? 0 : (state.scores[1] ? 1 : -1);
+        if (events & World::SCORED)
+        {
+            result.same = simScorer >= 0 && world.scores()[simScorer] == 1;
+            return result;
+        }
+        if (simScorer >= 0)
+        {
+            return result;
+        }
+
+        auto ballPos = entities.pos()[entities.index(world.ball())];
+        result.maxError = std::max(result.maxError, std::hypot(ballPos.x - state.ballX, ballPos.y - state.ballY));
+    }
+    result.same = true;
+    return result;
+}
+
+int main()
+{
+    static constexpr auto MATCHES = 10000;
+    static constexpr auto POINTS = 11;
+    static constexpr auto TIME_LIMIT = 600.0; /* CPU against CPU can rally forever */
+
+    for (auto right : {EventSim::IDLE, EventSim::CPU})
+    {
+        int same = 0;
+        double maxError = 0.0;
+        for (int i = 0; i < RALLIES; i++)
+        {
+            auto comparison = compare(i, right);
+            if (comparison.same && comparison.maxError < TOLERANCE)
+            {
+                same++;
+                maxError = std::max(maxError, comparison.maxError);
+            }
+        }
+        fmt::println("against World, {} right paddle: {}/{} first points identical, max ball distance {:.2g}",
+                     right == EventSim::IDLE ? "idle" : "cpu",
+                     same,
+                     RALLIES,
+                     maxError);
+        if (right == EventSim::IDLE && same < MIN_IDLE_SAME)
+        {
+            fmt::println(stderr, "EventSim no longer matches World with idle paddles: {}/{}, expected at least {}", same, RALLIES, MIN_IDLE_SAME);
+            return 1;
+        }
+    }
+
+    struct Setup
+    {
+        const char* name;
+        EventSim::Controller left, right;
+    };
+    static const Setup setups[] = {
+        {"idle-cpu", EventSim::IDLE, EventSim::CPU},
+        {"cpu-cpu", EventSim::CPU, EventSim::CPU},
+    };
+
+    fmt::println("{:>10} {:>8} {:>8} {:>14} {:>12} {:>14} {:>14}", "setup", "matches", "timeouts", "sim seconds", "events", "sim s/s", "ticks/s");
+    for (const auto& setup : setups)
+    {
+        double simulated = 0.0;
+        uint64_t events = 0;
+        int timeouts = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < MATCHES; i++)
+        {
+            EventSim sim(i, setup.left, setup.right);
+            if (sim.playMatch(POINTS, TIME_LIMIT) < 0)
+            {
+                timeouts++;
+            }
+            simulated += sim.state().time;
+            events += sim.events();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - begin).count();
+
+        fmt::println("{:>10} {:>8} {:>8} {:>14.0f} {:>12} {:>14.3g} {:>14.3g}",
+                     setup.name,
+                     MATCHES,
+                     timeouts,
+                     simulated,
+                     events,
+                     simulated / seconds,
+                     simulated * World::FPS / seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * Ticks per second of the floating point World against the Q16.16 fixed
+ * point one, with the ball served automatically and the keyboard paddle idle.
+ *
+ * Each run ends with a hash of the ball and paddle positions and the scores:
+ * the fixed point hashes must be the same across compilers, optimization
+ * levels and targets, the floating point ones may not.
+ */
+#include "bench.hpp"
+#include "fixedworld.hpp"
+#include "world.hpp"
+#include <fmt/format.h>
+#include <string.h>
+
+static constexpr uint64_t TICKS = 60 * 60 * World::FPS; /* an hour */
+static constexpr uint64_t SEED = 1;
+
+/* FNV-1a */
+static uint64_t hash(uint64_t h, const void* data, size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        h = (h ^ bytes[i]) * 0x100000001b3;
+    }
+    return h;
+}
+
+static uint64_t hashWorld(const World& world)
+{
+    const auto& entities = world.entities();
+    uint64_t h = 0xcbf29ce484222325;
+    for (size_t i = 0; i < entities.count(); i++)
+    {
+        h = hash(h, &entities.pos()[i], sizeof(entities.pos()[i]));
+    }
+    return hash(h, world.scores(), 2 * sizeof(int));
+}
+
+static uint64_t hashFixed(const FixedWorld& world)
+{
+    FixedVec2 state[] = {world.ballPos(), world.ballV(), world.paddlePos(0), world.paddlePos(1)};
+    uint64_t h = hash(0xcbf29ce484222325, state, sizeof(state));
+    return hash(h, world.scores(), 2 * sizeof(int));
+}
+
+int main()
+{
+    Keystate input {};
+    input.space = true;
+
+    fmt::println("{:>14} {:>12} {:>10} {:>18}", "physics", "ticks/s", "scores", "state hash");
+    for (auto physics : {World::Physics::FLOAT, World::Physics::FIXED})
+    {
+        World world;
+        world.setPhysics(physics);
+        world.init(SEED);
+        auto ns = measure(TICKS, [&]() { world.tick(input); }, 1);
+        fmt::println("{:>14} {:>12.0f} {:>4}-{:<5} {:>18x}",
+                     physics == World::Physics::FLOAT ? "world float" : "world fixed",
+                     1e9 / ns,
+                     world.scores()[0],
+                     world.scores()[1],
+                     hashWorld(world));
+    }
+
+    /* Without mirroring into the entities */
+    FixedWorld fixed;
+    fixed.init(SEED);
+    auto ns = measure(TICKS, [&]() { fixed.tick(input); }, 1);
+    fmt::println("{:>14} {:>12.0f} {:>4}-{:<5} {:>18x}", "fixedworld", 1e9 / ns, fixed.scores()[0], fixed.scores()[1], hashFixed(fixed));
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * Scaling of the match farm from one thread to one per hardware thread:
+ * match ticks per second, speedup and efficiency against a single thread,
+ * and a check that every thread count reaches the very same results.
+ *
+ * Then a sweep of the CPU paddle speed against the ball speed, to show what
+ * the farm is for.
+ */
+#include "matchfarm.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fmt/format.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+static constexpr size_t MATCHES = 64 * MatchFarm::BATCH_LANES;
+static constexpr size_t TICKS = 60 * 60; /* a minute */
+
+static bool sameResult(const FarmResult& a, const FarmResult& b)
+{
+    return !memcmp(&a, &b, sizeof(FarmResult));
+}
+
+int main()
+{
+    FarmSetup setup {BatchSim::CPU, BatchSim::CPU, BALL_SPEED, PADDLE_SPEED, MATCHES, TICKS, 1};
+
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    fmt::println("{} matches of {} ticks, {} hardware threads", MATCHES, TICKS, hardware);
+    fmt::println("{:>8} {:>14} {:>10} {:>12} {:>8}", "threads", "Mticks/s", "speedup", "efficiency", "check");
+
+    /* Powers of two below the hardware threads, then all of them */
+    std::vector<size_t> counts;
+    for (size_t threads = 1; threads < hardware; threads *= 2)
+    {
+        counts.push_back(threads);
+    }
+    counts.push_back(hardware);
+
+    FarmResult reference {};
+    double single = 0.0;
+    for (auto threads : counts)
+    {
+        JobPool pool(threads);
+        MatchFarm farm(pool);
+        farm.play(setup); /* warm up the threads and the kernel dispatch */
+
+        auto begin = std::chrono::steady_clock::now();
+        auto result = farm.play(setup);
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - begin).count();
+
+        if (threads == 1)
+        {
+            reference = result;
+            single = seconds;
+        }
+        double speedup = single / seconds;
+        fmt::println("{:>8} {:>14.1f} {:>10.2f} {:>11.0f}% {:>8}",
+                     threads,
+                     result.ticks / seconds / 1e6,
+                     speedup,
+                     speedup / threads * 100.0,
+                     sameResult(result, reference) ? "ok" : "MISMATCH");
+    }
+
+    static constexpr size_t STEPS = 7;
+    FarmSetup setups[STEPS];
+    FarmResult results[STEPS];
+    for (size_t i = 0; i < STEPS; i++)
+    {
+        setups[i] = setup;
+        setups[i].matches = 8 * MatchFarm::BATCH_LANES;
+        setups[i].right = BatchSim::IDLE;
+        setups[i].paddleSpeed = BALL_SPEED * (0.4f + (0.2f * i));
+    }
+
+    JobPool pool;
+    MatchFarm farm(pool);
+    farm.sweep(setups, STEPS, results);
+
+    fmt::println("");
+    fmt::println("cpu against idle paddle, {} matches of {} ticks each", setups[0].matches, TICKS);
+    fmt::println("{:>14} {:>10} {:>10} {:>14}", "paddle speed", "cpu wins", "draws", "ticks/point");
+    for (size_t i = 0; i < STEPS; i++)
+    {
+        const auto& result = results[i];
+        auto points = result.points[0] + result.points[1];
+        fmt::println("{:>13.1f}x {:>9.1f}% {:>9.1f}% {:>14.1f}",
+                     setups[i].paddleSpeed / BALL_SPEED,
+                     result.wins[0] * 100.0 / result.matches,
+                     result.draws * 100.0 / result.matches,
+                     points ? static_cast<double>(result.ticks) / points : 0.0);
+    }
+    return 0;
+}
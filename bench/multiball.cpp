@@ -0,0 +1,46 @@
+/*
+ * Multiball load test: cost of a World tick as the number of balls grows
+ * from the standard match to MAX_BALLS, with the collision work behind it.
+ *
+ * The balls are served on the first tick and play for a few seconds, long
+ * enough to spread over the field and bounce off every wall and paddle.
+ */
+#include "bench.hpp"
+#include "world.hpp"
+#include <fmt/format.h>
+
+static constexpr int TICKS = 5 * World::FPS;
+
+int main()
+{
+    fmt::println("{:>8} {:>10} {:>10} {:>10} {:>10} {:>8}", "balls", "tick us", "ns/ball", "pairs", "contacts", "points");
+    for (size_t balls : {size_t {1}, size_t {10}, size_t {100}, size_t {1000}, size_t {10000}, size_t {100000}})
+    {
+        World world;
+        world.setBalls(balls);
+        world.init(1);
+        Keystate serve {};
+        serve.space = true;
+
+        size_t pairs = 0;
+        size_t contacts = 0;
+        auto step = measure(TICKS,
+                            [&]()
+                            {
+                                world.tick(serve);
+                                pairs += world.pairTests();
+                                contacts += world.contactCount();
+                            },
+                            1);
+
+        auto scores = world.scores();
+        fmt::println("{:>8} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>8}",
+                     balls,
+                     step / 1000.0,
+                     step / balls,
+                     static_cast<double>(pairs) / TICKS,
+                     static_cast<double>(contacts) / TICKS,
+                     scores[0] + scores[1]);
+    }
+    return 0;
+}
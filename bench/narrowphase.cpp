@@ -0,0 +1,66 @@
+/*
+ * Pairs per second of each narrowphase kernel supported by this CPU, with a
+ * check that every kernel produces the same contacts as the scalar one.
+ */
+#include "bench.hpp"
+#include "narrowphase.hpp"
+#include "rng.hpp"
+#include <algorithm>
+#include <fmt/format.h>
+#include <string.h>
+#include <vector>
+
+int main()
+{
+    static constexpr size_t BODIES = 4096;
+
+    Rng rng(99);
+    std::vector<glm::vec2> pos(BODIES);
+    std::vector<glm::vec2> size(BODIES);
+    for (size_t i = 0; i < BODIES; i++)
+    {
+        pos[i] = {(rng.fnext() - 0.5f) * 1.77f, rng.fnext() - 0.5f};
+        size[i] = {0.02f + rng.fnext() * 0.08f, 0.02f + rng.fnext() * 0.08f};
+    }
+
+    size_t kernelCount;
+    auto kernels = narrowphaseKernels(&kernelCount);
+
+    fmt::println("{:>8} {:>10} {:>10} {:>14} {:>8}", "kernel", "pairs", "contacts", "Mpairs/s", "check");
+    for (size_t pairCount : {1000, 16384, 262144})
+    {
+        /* Pairs mostly close to each other, as a broadphase would report */
+        std::vector<BodyPair> pairs(pairCount);
+        for (auto& pair : pairs)
+        {
+            pair.a = rng.next() % BODIES;
+            do
+            {
+                pair.b = rng.next() % BODIES;
+            } while (pair.b == pair.a);
+            if (rng.next() & 1)
+            {
+                pos[pair.b] = pos[pair.a] + glm::vec2 {(rng.fnext() - 0.5f) * 0.1f, (rng.fnext() - 0.5f) * 0.1f};
+            }
+        }
+
+        std::vector<Contact> reference(pairCount);
+        auto referenceCount = kernels[0].run(pairs.data(), pairCount, pos.data(), size.data(), reference.data());
+
+        for (size_t k = 0; k < kernelCount; k++)
+        {
+            std::vector<Contact> contacts(pairCount);
+            size_t contactCount = 0;
+            auto ns = measure(std::max<size_t>(1, 1000000 / pairCount),
+                              [&]()
+                              {
+                                  contactCount = kernels[k].run(pairs.data(), pairCount, pos.data(), size.data(), contacts.data());
+                                  doNotOptimize(contactCount);
+                              });
+
+            bool same = contactCount == referenceCount && !memcmp(contacts.data(), reference.data(), contactCount * sizeof(Contact));
+            fmt::println("{:>8} {:>10} {:>10} {:>14.1f} {:>8}", kernels[k].name, pairCount, contactCount, pairCount / ns * 1000.0, same ? "ok" : "MISMATCH");
+        }
+    }
+    return 0;
+}
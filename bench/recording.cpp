@@ -0,0 +1,107 @@
+/*
+ * Recordings: size of a scripted ten minute match once encoded, and the time
+ * to replay it headless through World with each physics.
+ *
+ * The script holds random keys for 1 to 40 ticks at a time, about 20 on
+ * average. Also checks that decoding gives back every tick and that two
+ * replays of the same file end in the same state.
+ */
+#include "recording.hpp"
+#include "world.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fmt/format.h>
+
+static constexpr uint64_t TICKS = 10 * 60 * World::FPS;
+static constexpr uint64_t SEED = 12345;
+static constexpr int ROUNDS = 5;
+
+static Recording script(World::Physics physics)
+{
+    Recording recording;
+    recording.start(SEED, physics);
+    Rng rng(SEED);
+    Keystate keys {};
+    uint64_t hold = 0;
+    for (uint64_t t = 0; t < TICKS; t++)
+    {
+        if (!hold)
+        {
+            keys = unpackKeys(static_cast<uint8_t>(rng.next() & 31));
+            hold = 1 + (rng.next() % 40);
+        }
+        recording.record(keys);
+        hold--;
+    }
+    return recording;
+}
+
+struct Replay
+{
+    double ms;
+    int scores[2];
+    glm::vec2 ball;
+};
+
+static Replay replay(Recording& recording)
+{
+    World world;
+    world.setPhysics(recording.physics());
+    world.setTickRate(recording.tickRate());
+    world.setBotSkill(recording.bot());
+    world.init(recording.seed());
+    recording.rewind();
+
+    auto begin = std::chrono::steady_clock::now();
+    Keystate input {};
+    while (recording.next(input))
+    {
+        world.tick(input);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const auto& entities = world.entities();
+    return {std::chrono::duration<double, std::milli>(end - begin).count(),
+            {world.scores()[0], world.scores()[1]},
+            entities.pos()[entities.index(world.ball())]};
+}
+
+int main()
+{
+    fmt::println("{:>8} {:>8} {:>10} {:>10} {:>10} {:>8} {:>8}", "physics", "ticks", "bytes", "bytes/min", "replay ms", "scores", "check");
+    for (auto physics : {World::Physics::FLOAT, World::Physics::FIXED})
+    {
+        auto recorded = script(physics);
+        auto data = recorded.encode();
+        Recording decoded;
+        if (!decoded.decode(data.data(), data.size()) || decoded.ticks() != TICKS)
+        {
+            fmt::println(stderr, "Failed to decode the recording");
+            return 1;
+        }
+
+        auto first = replay(decoded);
+        bool same = true;
+        double best = first.ms;
+        for (int round = 1; round < ROUNDS; round++)
+        {
+            auto again = replay(decoded);
+            same = same && again.scores[0] == first.scores[0] && again.scores[1] == first.scores[1] && again.ball == first.ball;
+            best = std::min(best, again.ms);
+        }
+
+        fmt::println("{:>8} {:>8} {:>10} {:>10.0f} {:>10.2f} {:>8} {:>8}",
+                     physics == World::Physics::FLOAT ? "float" : "fixed",
+                     decoded.ticks(),
+                     data.size(),
+                     data.size() / 10.0,
+                     best,
+                     fmt::format("{}-{}", first.scores[0], first.scores[1]),
+                     same ? "ok" : "FAILED");
+        if (!same)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * Rollback sessions of two peers over a loopback link, under increasingly bad
+ * conditions. Each peer is a bot following the ball, the left one serving.
+ *
+ * Reports how often and how deep the peers roll back, the time spent
+ * simulating again, and checks that both peers agree to the bit on the state
+ * of every tick whose inputs they both know.
+ */
+#include "rollback.hpp"
+#include "snapshot.hpp"
+#include "transport.hpp"
+#include "world.hpp"
+#include <algorithm>
+#include <fmt/format.h>
+#include <string.h>
+
+static constexpr uint32_t TICKS = 60 * World::FPS;
+static constexpr uint64_t SEED = 1;
+
+/* Up or down towards the ball, from the peer's own, possibly mispredicted, World */
+static Keystate bot(const World& world, int side)
+{
+    const auto& entities = world.entities();
+    auto ball = entities.pos()[entities.index(world.ball())];
+    Keystate input {};
+    input.space = side == 0;
+    for (size_t i = 0; i < entities.count(); i++)
+    {
+        auto behavior = entities.behavior()[i];
+        if (behavior.kind == Behavior::PADDLE && behavior.player == side)
+        {
+            input.up = ball.y < entities.pos()[i].y - 0.05f;
+            input.down = ball.y > entities.pos()[i].y + 0.05f;
+        }
+    }
+    return input;
+}
+
+int main()
+{
+    static const LinkConditions conditions[] = {
+        {0.0, 0.0, 0.0},
+        {20.0, 5.0, 0.0},
+        {50.0, 20.0, 0.05},
+        {100.0, 40.0, 0.2},
+    };
+
+    fmt::println("{:>8} {:>8} {:>6} {:>10} {:>10} {:>10} {:>12} {:>8} {:>10}",
+                 "latency", "jitter", "loss", "rollbacks", "avg depth", "max depth", "avg resim us", "stalls", "desyncs");
+    for (const auto& condition : conditions)
+    {
+        World worlds[2];
+        LoopbackLink link(condition, SEED);
+        RollbackSession* sessions[2];
+        for (int side = 0; side < 2; side++)
+        {
+            worlds[side].setPlayers(2);
+            worlds[side].init(SEED);
+        }
+        RollbackSession left(worlds[0], link.end(0), 0);
+        RollbackSession right(worlds[1], link.end(1), 1);
+        sessions[0] = &left;
+        sessions[1] = &right;
+
+        uint64_t depths = 0;
+        int maxDepth = 0;
+        double resimulateMs = 0.0;
+        uint64_t checks = 0;
+        uint64_t desyncs = 0;
+        for (uint64_t frame = 0; left.stats().tick < TICKS || right.stats().tick < TICKS; frame++)
+        {
+            link.setTime(frame * 1000000000 / World::FPS);
+            for (int side = 0; side < 2; side++)
+            {
+                uint8_t events;
+                sessions[side]->advance(bot(worlds[side], side), events);
+                depths += sessions[side]->stats().depth;
+                maxDepth = std::max(maxDepth, sessions[side]->stats().depth);
+                resimulateMs += sessions[side]->stats().resimulateMs;
+            }
+
+            WorldSnapshot a, b;
+            auto tick = std::min(left.stats().confirmed, right.stats().confirmed);
+            if (left.snapshot(tick, a) && right.snapshot(tick, b))
+            {
+                checks++;
+                desyncs += memcmp(&a, &b, sizeof(WorldSnapshot)) != 0;
+            }
+        }
+
+        auto rollbacks = left.stats().rollbacks + right.stats().rollbacks;
+        fmt::println("{:>6.0f}ms {:>6.0f}ms {:>5.0f}% {:>10} {:>10.1f} {:>10} {:>12.1f} {:>8} {:>5}/{:<5}",
+                     condition.latencyMs,
+                     condition.jitterMs,
+                     condition.loss * 100.0,
+                     rollbacks,
+                     rollbacks ? static_cast<double>(depths) / rollbacks : 0.0,
+                     maxDepth,
+                     rollbacks ? resimulateMs * 1000.0 / rollbacks : 0.0,
+                     left.stats().stalls + right.stats().stalls,
+                     desyncs,
+                     checks);
+    }
+    return 0;
+}
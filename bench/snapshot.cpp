@@ -0,0 +1,78 @@
+/*
+ * Cost of World snapshots: saving, restoring and copying one into a ring
+ * buffer the way a rollback would, next to the cost of a tick.
+ *
+ * Also checks that a restored World replays the same ticks to the bit.
+ */
+#include "bench.hpp"
+#include "snapshot.hpp"
+#include "world.hpp"
+#include <fmt/format.h>
+#include <string.h>
+
+static constexpr int TICKS = 10 * World::FPS;
+static constexpr size_t RING = 64;
+
+/* The keyboard paddle goes up and down while the ball is served */
+static Keystate input(int tick)
+{
+    Keystate keys {};
+    keys.space = true;
+    keys.up = (tick / 40) % 3 == 0;
+    keys.down = (tick / 40) % 3 == 1;
+    return keys;
+}
+
+static void play(World& world, int from)
+{
+    for (int t = from; t < from + TICKS; t++)
+    {
+        world.tick(input(t));
+    }
+}
+
+int main()
+{
+    fmt::println("sizeof(WorldSnapshot) = {} bytes", sizeof(WorldSnapshot));
+    fmt::println("{:>8} {:>10} {:>12} {:>10} {:>10} {:>8}", "physics", "save ns", "restore ns", "copy ns", "tick ns", "check");
+    for (auto physics : {World::Physics::FLOAT, World::Physics::FIXED})
+    {
+        World world;
+        world.setPhysics(physics);
+        world.init(1);
+        play(world, 0);
+
+        WorldSnapshot start, first, second;
+        world.save(start);
+        play(world, TICKS);
+        world.save(first);
+        world.restore(start);
+        play(world, TICKS);
+        world.save(second);
+        bool same = !memcmp(&first, &second, sizeof(WorldSnapshot));
+
+        static WorldSnapshot ring[RING];
+        size_t slot = 0;
+        auto save = measure(1000000, [&]() { world.save(ring[slot++ % RING]); });
+        auto restore = measure(1000000, [&]() { world.restore(ring[slot++ % RING]); });
+        auto copy = measure(1000000,
+                            [&]()
+                            {
+                                memcpy(&ring[(slot + 1) % RING], &ring[slot % RING], sizeof(WorldSnapshot));
+                                slot++;
+                                doNotOptimize(ring[slot % RING]);
+                            });
+        world.restore(start);
+        int tick = TICKS;
+        auto step = measure(TICKS, [&]() { world.tick(input(tick++)); }, 1);
+
+        fmt::println("{:>8} {:>10.1f} {:>12.1f} {:>10.1f} {:>10.1f} {:>8}",
+                     physics == World::Physics::FLOAT ? "float" : "fixed",
+                     save,
+                     restore,
+                     copy,
+                     step,
+                     same ? "ok" : "MISMATCH");
+    }
+    return 0;
+}
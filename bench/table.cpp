@@ -0,0 +1,84 @@
+/*
+ * Policy lookup table: solves the table and writes it, maps it back, then
+ * compares the cost of a table paddle per lane with the other controllers
+ * of a BatchSim and plays the table against each opponent.
+ *
+ * Usage: bench_table [FILE], the table is written to FILE (default
+ * policy.lut) for the game's --table option.
+ */
+#include "batchsim.hpp"
+#include "bench.hpp"
+#include "policytable.hpp"
+#include <chrono>
+#include <fmt/format.h>
+
+static constexpr size_t LANES = 16384;
+
+int main(int argc, char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : "policy.lut";
+
+    auto begin = std::chrono::steady_clock::now();
+    if (!PolicyTable::build(path))
+    {
+        fmt::println(stderr, "Failed to write {}", path);
+        return 1;
+    }
+    auto built = std::chrono::steady_clock::now();
+    PolicyTable table;
+    if (!table.map(path))
+    {
+        fmt::println(stderr, "Failed to map {}", path);
+        return 1;
+    }
+    auto mapped = std::chrono::steady_clock::now();
+    fmt::println("{} cells ({} KiB) solved and written to {} in {:.2f}s, mapped in {:.1f}us",
+                 PolicyTable::CELLS,
+                 (PolicyTable::HEADER_SIZE + PolicyTable::BYTES) / 1024,
+                 path,
+                 std::chrono::duration<double>(built - begin).count(),
+                 std::chrono::duration<double, std::micro>(mapped - built).count());
+    fmt::println("");
+
+    /* The right paddle only, against an idle one: the kernel is the same for all, the paddle costs the rest */
+    fmt::println("{:>8} {:>12} {:>12} {:>12}", "paddle", "ns/lane", "paddle ns", "Mticks/s");
+    double ns[BatchSim::TABLE + 1];
+    for (auto controller : {BatchSim::IDLE, BatchSim::CPU, BatchSim::BOT, BatchSim::MLP, BatchSim::TABLE})
+    {
+        static const char* NAMES[] = {"idle", "cpu", "bot", "mlp", "table"};
+        BatchSim sim(LANES, 1, BatchSim::IDLE, controller);
+        sim.setTable(1, &table);
+        ns[controller] = measure(100, [&]() { sim.tick(); }) / LANES;
+        fmt::println("{:>8} {:>12.2f} {:>12.2f} {:>12.1f}", NAMES[controller], ns[controller], ns[controller] - ns[BatchSim::IDLE], 1000.0 / ns[controller]);
+    }
+    fmt::println("table paddle {:.2f}x the cost of the bot", (ns[BatchSim::TABLE] - ns[BatchSim::IDLE]) / (ns[BatchSim::BOT] - ns[BatchSim::IDLE]));
+    fmt::println("");
+
+    /* Points per match of the table on the right against each opponent */
+    fmt::println("{:>8} {:>10} {:>10}", "opponent", "won", "lost");
+    size_t skillCount;
+    auto skills = botSkills(&skillCount);
+    for (size_t s = 0; s <= skillCount + 1; s++)
+    {
+        auto controller = s == 0 ? BatchSim::IDLE : (s == 1 ? BatchSim::CPU : BatchSim::BOT);
+        BatchSim sim(LANES / 16, 12345, controller, BatchSim::TABLE);
+        sim.setTable(1, &table);
+        if (s >= 2)
+        {
+            sim.setSkill(0, skills[s - 2]);
+        }
+        for (size_t t = 0; t < 60 * 60; t++)
+        {
+            sim.tick();
+        }
+        double won = 0.0;
+        double lost = 0.0;
+        for (size_t lane = 0; lane < sim.lanes(); lane++)
+        {
+            won += sim.scores(1)[lane];
+            lost += sim.scores(0)[lane];
+        }
+        fmt::println("{:>8} {:>10.2f} {:>10.2f}", s == 0 ? "idle" : (s == 1 ? "cpu" : skills[s - 2].name), won / sim.lanes(), lost / sim.lanes());
+    }
+    return 0;
+}
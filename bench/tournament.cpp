@@ -0,0 +1,144 @@
+/*
+ * Round robin between the paddle policies: the idle paddle, the chasing CPU
+ * and the bot at every skill, each pairing played on both sides.
+ *
+ * Prints the standings with win rates and Elo ratings, the win rate of every
+ * pairing, and how long the rallies of each policy last. A smaller
+ * tournament is then played on a single thread to check that the results do
+ * not depend on the number of threads.
+ */
+#include "tournament.hpp"
+#include "world.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fmt/format.h>
+#include <string.h>
+#include <vector>
+
+static constexpr size_t MATCHES = 2 * MatchFarm::BATCH_LANES; /* per pairing and side */
+static constexpr size_t TICKS = 60 * 60;                       /* a minute */
+
+static bool sameResult(const TournamentResult& a, const TournamentResult& b)
+{
+    for (size_t i = 0; i < a.pairings.size(); i++)
+    {
+        if (memcmp(&a.pairings[i], &b.pairings[i], sizeof(FarmResult)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    std::vector<PaddlePolicy> policies {{"idle", BatchSim::IDLE, nullptr}, {"cpu", BatchSim::CPU, nullptr}};
+    size_t skillCount;
+    auto skills = botSkills(&skillCount);
+    for (size_t s = 0; s < skillCount; s++)
+    {
+        policies.push_back({skills[s].name, BatchSim::BOT, &skills[s]});
+    }
+    auto count = policies.size();
+    TournamentSetup setup {policies.data(), count, MATCHES, TICKS, 1};
+
+    JobPool pool;
+    MatchFarm farm(pool);
+    auto begin = std::chrono::steady_clock::now();
+    auto result = playTournament(farm, setup);
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    fmt::println("{} matches of {} ticks on {} threads in {:.1f}s, {:.0f} matches/s, {:.1f} Mticks/s",
+                 result.matches,
+                 TICKS,
+                 pool.threads(),
+                 seconds,
+                 result.matches / seconds,
+                 result.ticks / seconds / 1e6);
+    fmt::println("");
+
+    std::vector<size_t> ranking(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        ranking[i] = i;
+    }
+    std::stable_sort(ranking.begin(), ranking.end(), [&](size_t a, size_t b) { return result.standings[a].elo > result.standings[b].elo; });
+
+    fmt::println("{:>8} {:>8} {:>8} {:>8} {:>8} {:>10} {:>10} {:>8}", "policy", "matches", "won", "drawn", "lost", "points", "conceded", "elo");
+    for (auto i : ranking)
+    {
+        const auto& standing = result.standings[i];
+        fmt::println("{:>8} {:>8} {:>7.1f}% {:>7.1f}% {:>7.1f}% {:>10} {:>10} {:>8.0f}",
+                     policies[i].name,
+                     standing.matches,
+                     standing.wins * 100.0 / standing.matches,
+                     standing.draws * 100.0 / standing.matches,
+                     standing.losses * 100.0 / standing.matches,
+                     standing.pointsFor,
+                     standing.pointsAgainst,
+                     standing.elo);
+    }
+    fmt::println("");
+
+    /* Both sides of a pairing together, a draw counting half */
+    fmt::print("{:>8}", "score");
+    for (auto j : ranking)
+    {
+        fmt::print(" {:>8}", policies[j].name);
+    }
+    fmt::println("");
+    for (auto i : ranking)
+    {
+        fmt::print("{:>8}", policies[i].name);
+        for (auto j : ranking)
+        {
+            if (i == j)
+            {
+                fmt::print(" {:>8}", "-");
+                continue;
+            }
+            const auto& home = result.pairings[(i * count) + j];
+            const auto& away = result.pairings[(j * count) + i];
+            double score = home.wins[0] + away.wins[1] + ((home.draws + away.draws) / 2.0);
+            fmt::print(" {:>7.1f}%", score * 100.0 / (home.matches + away.matches));
+        }
+        fmt::println("");
+    }
+    fmt::println("");
+
+    /* Share of the rallies in each bin, the last one open ended */
+    fmt::print("{:>8}", "rally s");
+    for (auto i : ranking)
+    {
+        fmt::print(" {:>8}", policies[i].name);
+    }
+    fmt::println("");
+    for (size_t bin = 0; bin < FarmResult::RALLY_BINS; bin++)
+    {
+        double from = static_cast<double>(bin * FarmResult::RALLY_BIN_TICKS) / World::FPS;
+        fmt::print("{:>7.1f}{}", from, bin + 1 < FarmResult::RALLY_BINS ? " " : "+");
+        for (auto i : ranking)
+        {
+            const auto& standing = result.standings[i];
+            uint64_t total = 0;
+            for (auto rallies : standing.rallies)
+            {
+                total += rallies;
+            }
+            fmt::print(" {:>7.1f}%", total ? standing.rallies[bin] * 100.0 / total : 0.0);
+        }
+        fmt::println("");
+    }
+    fmt::println("");
+
+    setup.matches = MatchFarm::BATCH_LANES / 4;
+    auto threaded = playTournament(farm, setup);
+    JobPool single(1);
+    MatchFarm singleFarm(single);
+    auto reference = playTournament(singleFarm, setup);
+    fmt::println("{} matches on {} threads and on one: {}",
+                 reference.matches,
+                 pool.threads(),
+                 sameResult(threaded, reference) ? "ok" : "MISMATCH");
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Evolution strategies training of an MlpPolicy against the chasing CPU
+ * paddle, then a match of the trained policy against each opponent.
+ *
+ * Usage: bench_train [FILE [GENERATIONS]], the policy is saved to FILE
+ * (default policy.mlp) for the game's --mlp option.
+ *
+ * Also checks that the scalar and AVX2 inference kernels agree to the bit
+ * and measures them.
+ */
+#include "bench.hpp"
+#include "trainer.hpp"
+#include <chrono>
+#include <fmt/format.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static constexpr size_t LANES = 16384;
+
+int main(int argc, char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : "policy.mlp";
+    size_t generations = argc > 2 ? strtoull(argv[2], nullptr, 10) : 150;
+
+    JobPool pool;
+    TrainerSetup setup {BatchSim::CPU, nullptr, 64, 256, 60 * 30, 0.1f, 0.05f, 1};
+    EvolutionTrainer trainer(pool, setup);
+    fmt::println("{} parameters, {} candidates of {} matches of {} ticks per generation, {} threads",
+                 MlpPolicy::PARAMETERS,
+                 setup.population,
+                 setup.matches,
+                 setup.ticks,
+                 pool.threads());
+    fmt::println("{:>10} {:>12} {:>12} {:>10}", "generation", "population", "policy", "seconds");
+
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t g = 1; g <= generations; g++)
+    {
+        auto population = trainer.step();
+        if (g % 10 == 0 || g == generations)
+        {
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            fmt::println("{:>10} {:>12.3f} {:>12.3f} {:>10.1f}", g, population, trainer.evaluate(trainer.policy(), 0), seconds);
+        }
+    }
+    if (!trainer.policy().save(path))
+    {
+        fmt::println(stderr, "Failed to save {}", path);
+        return 1;
+    }
+    fmt::println("saved to {}", path);
+    fmt::println("");
+
+    /* Points per match of the policy on the right against each opponent, on fresh serves */
+    fmt::println("{:>8} {:>10} {:>10}", "opponent", "won", "lost");
+    size_t skillCount;
+    auto skills = botSkills(&skillCount);
+    for (size_t s = 0; s <= skillCount + 1; s++)
+    {
+        auto controller = s == 0 ? BatchSim::IDLE : (s == 1 ? BatchSim::CPU : BatchSim::BOT);
+        BatchSim sim(LANES / 16, 12345, controller, BatchSim::MLP);
+        sim.setPolicy(1, trainer.policy());
+        if (s >= 2)
+        {
+            sim.setSkill(0, skills[s - 2]);
+        }
+        for (size_t t = 0; t < 60 * 60; t++)
+        {
+            sim.tick();
+        }
+        double won = 0.0;
+        double lost = 0.0;
+        for (size_t lane = 0; lane < sim.lanes(); lane++)
+        {
+            won += sim.scores(1)[lane];
+            lost += sim.scores(0)[lane];
+        }
+        fmt::println("{:>8} {:>10.2f} {:>10.2f}", s == 0 ? "idle" : (s == 1 ? "cpu" : skills[s - 2].name), won / sim.lanes(), lost / sim.lanes());
+    }
+    fmt::println("");
+
+    /* Inference alone, on the lanes of a BatchSim in play */
+    BatchSim sim(LANES, 7, BatchSim::CPU, BatchSim::CPU);
+    for (int t = 0; t < 100; t++)
+    {
+        sim.tick();
+    }
+    MlpInputs inputs {sim.ballX(), sim.ballY(), sim.ballVX(), sim.ballVY(), sim.paddleY(1), 1.0f};
+    size_t kernelCount;
+    auto kernels = mlpKernels(&kernelCount);
+    std::vector<float> reference(LANES);
+    std::vector<float> actions(LANES);
+    kernels[0].run(trainer.policy(), inputs, LANES, reference.data());
+    fmt::println("{:>8} {:>10} {:>8}", "kernel", "ns/lane", "check");
+    for (size_t k = 0; k < kernelCount; k++)
+    {
+        auto ns = measure(100, [&]() { kernels[k].run(trainer.policy(), inputs, LANES, actions.data()); });
+        bool same = !memcmp(actions.data(), reference.data(), LANES * sizeof(float));
+        fmt::println("{:>8} {:>10.2f} {:>8}", kernels[k].name, ns / LANES, same ? "ok" : "MISMATCH");
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "bot.hpp"
+
+#include "rules.hpp"
+#include <cmath>
+#include <string.h>
+
+/* Ball center positions on contact */
+static constexpr float BALL_MAX_Y = (GAME_HEIGHT - BALL_SIZE) / 2.0f;
+static constexpr float FACE_OFFSET = (PADDLE_WIDTH + BALL_SIZE) / 2.0f;
+
+static constexpr BotSkill SKILLS[] = {
+    {"easy", 15, 0.12f},
+    {"normal", 8, 0.06f},
+    {"hard", 3, 0.02f},
+    {"perfect", 0, 0.0f},
+};
+
+const BotSkill* botSkills(size_t* count)
+{
+    *count = sizeof(SKILLS) / sizeof(SKILLS[0]);
+    return SKILLS;
+}
+
+const BotSkill* findBotSkill(const char* name)
+{
+    for (const auto& skill : SKILLS)
+    {
+        if (!strcmp(skill.name, name))
+        {
+            return &skill;
+        }
+    }
+    return nullptr;
+}
+
+/*
+ * Without walls the ball would reach y + v.y * t. Mirroring the field across
+ * its walls repeats it every 4 * BALL_MAX_Y, a triangle wave which folds that
+ * position back inside.
+ */
+float interceptY(glm::vec2 pos, glm::vec2 v, float x)
+{
+    float y = pos.y + (v.y * ((x - pos.x) / v.x));
+    float period = 4.0f * BALL_MAX_Y;
+    float phase = std::fmod(y + BALL_MAX_Y, period);
+    if (phase < 0.0f)
+    {
+        phase += period;
+    }
+    return phase <= 2.0f * BALL_MAX_Y ? phase - BALL_MAX_Y : (3.0f * BALL_MAX_Y) - phase;
+}
+
+/* Aims at the intercept, or waits in the middle while the ball goes away */
+void Bot::plan(const BotSkill& skill, glm::vec2 paddle, glm::vec2 ball, glm::vec2 ballV, Rng& rng)
+{
+    float faceX = paddle.x - (paddle.x > 0.0f ? FACE_OFFSET : -FACE_OFFSET);
+    bool incoming = ballV.x * paddle.x > 0.0f;
+    if (incoming && (faceX - ball.x) * paddle.x > 0.0f)
+    {
+        targetY = interceptY(ball, ballV, faceX) + (((rng.fnext() * 2.0f) - 1.0f) * skill.error);
+    }
+    else
+    {
+        targetY = incoming ? ball.y : 0.0f;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "rng.hpp"
+#include <glm/glm.hpp>
+#include <stdint.h>
+
+/* How well a Bot plays */
+struct BotSkill
+{
+    const char* name;
+    int reactionTicks; /* ticks between a change of the ball's course and the bot noticing it */
+    float error;       /* largest distance between the aimed and the actual intercept */
+};
+
+/* Presets from easy to perfect, easiest first */
+const BotSkill* botSkills(size_t* count);
+const BotSkill* findBotSkill(const char* name);
+
+/*
+ * Where a ball at pos moving at v crosses x, reflections off the top and
+ * bottom walls folded in analytically. v.x must head towards x.
+ */
+float interceptY(glm::vec2 pos, glm::vec2 v, float x);
+
+/*
+ * Predictive paddle AI.
+ *
+ * A bot plans once per course of the ball: when the sign of either velocity
+ * component changes (a serve, a bounce), it waits reactionTicks, then aims
+ * at the point where the ball will reach its paddle, give or take the skill
+ * error, or at the middle of its side while the ball goes away. Every other
+ * tick only compares signs and steers towards the plan, so a bot costs a few
+ * instructions per tick and never allocates.
+ *
+ * Trivially copyable, so it lives in World::State and in the lanes of a
+ * BatchSim.
+ */
+struct Bot
+{
+    float targetY = 0.0f;
+    int16_t countdown = 0;  /* ticks left before planning plus one, 0 once planned */
+    int8_t courseX = 0;     /* signs of the ball velocity the plan is for */
+    int8_t courseY = 0;
+
+    /* Sign of the paddle's next move along y: -1, 0 or 1. step is how far a paddle moves in a tick. */
+    int think(const BotSkill& skill, glm::vec2 paddle, glm::vec2 ball, glm::vec2 ballV, float step, Rng& rng)
+    {
+        auto x = static_cast<int8_t>((ballV.x > 0.0f) - (ballV.x < 0.0f));
+        auto y = static_cast<int8_t>((ballV.y > 0.0f) - (ballV.y < 0.0f));
+        if (x != courseX || y != courseY)
+        {
+            courseX = x;
+            courseY = y;
+            countdown = static_cast<int16_t>(skill.reactionTicks + 1);
+        }
+
+        /* Counts down without a branch, only the rare planning tick takes one */
+        int ticks = countdown;
+        countdown = static_cast<int16_t>(ticks - (ticks > 0));
+        if (ticks == 1)
+        {
+            plan(skill, paddle, ball, ballV, rng);
+        }
+
+        /* Branch-free, lanes of a batch steer independently */
+        float gap = targetY - paddle.y;
+        return (gap > step / 2.0f) - (gap < step / -2.0f);
+    }
+
+private:
+    void plan(const BotSkill& skill, glm::vec2 paddle, glm::vec2 ball, glm::vec2 ballV, Rng& rng);
+};
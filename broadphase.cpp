@@ -0,0 +1,274 @@
+#include "broadphase.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+static BodyPair makePair(uint32_t a, uint32_t b)
+{
+    return a < b ? BodyPair {a, b} : BodyPair {b, a};
+}
+
+/*** BruteForceBroadphase *************************************************************/
+const char* BruteForceBroadphase::name() const
+{
+    return "brute";
+}
+
+void BruteForceBroadphase::findPairs(const uint32_t* bodies, size_t count, const glm::vec2* pos, const glm::vec2* size, ArenaVector<BodyPair>& pairs)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        for (size_t j = i + 1; j < count; j++)
+        {
+            pairs.push_back(makePair(bodies[i], bodies[j]));
+        }
+    }
+}
+
+/*** GridBins ***********************************************************************/
+GridBins::GridBins(glm::vec2 min, glm::vec2 max, float cellSize)
+    : _min(min),
+      _invCellSize(1.0f / cellSize),
+      _columns(std::max(1, static_cast<int>(std::ceil((max.x - min.x) / cellSize)))),
+      _rows(std::max(1, static_cast<int>(std::ceil((max.y - min.y) / cellSize)))),
+      _cellStart(_columns * _rows + 1)
+{
+}
+
+int GridBins::column(float x) const
+{
+    return std::clamp(static_cast<int>((x - _min.x) * _invCellSize), 0, _columns - 1);
+}
+
+int GridBins::row(float y) const
+{
+    return std::clamp(static_cast<int>((y - _min.y) * _invCellSize), 0, _rows - 1);
+}
+
+int GridBins::cellCount() const
+{
+    return _columns * _rows;
+}
+
+int GridBins::cell(glm::vec2 p) const
+{
+    return row(p.y) * _columns + column(p.x);
+}
+
+const uint32_t* GridBins::begin(int cell) const
+{
+    return _cellEntries.data() + _cellStart[cell];
+}
+
+const uint32_t* GridBins::end(int cell) const
+{
+    return _cellEntries.data() + _cellStart[cell + 1];
+}
+
+void GridBins::fill(const uint32_t* bodies, size_t count, const glm::vec2* pos, const glm::vec2* size)
+{
+    /* Count the population of each cell */
+    std::fill(_cellStart.begin(), _cellStart.end(), 0);
+    size_t entries = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        auto body = bodies[i];
+        forEachCell(pos[body] - size[body] / 2.0f,
+                    pos[body] + size[body] / 2.0f,
+                    [this, &entries](int cell)
+                    {
+                        _cellStart[cell + 1]++;
+                        entries++;
+                    });
+    }
+
+    for (size_t i = 1; i < _cellStart.size(); i++)
+    {
+        _cellStart[i] += _cellStart[i - 1];
+    }
+
+    /* Scatter the bodies, using the start of the next cell as a cursor */
+    if (_cellEntries.size() < entries)
+    {
+        _cellEntries.resize(entries);
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        auto body = bodies[i];
+        forEachCell(pos[body] - size[body] / 2.0f,
+                    pos[body] + size[body] / 2.0f,
+                    [this, body](int cell)
+                    {
+                        _cellEntries[_cellStart[cell]++] = body;
+                    });
+    }
+
+    /* The scatter shifted every start by one cell */
+    memmove(_cellStart.data() + 1, _cellStart.data(), (_cellStart.size() - 1) * sizeof(uint32_t));
+    _cellStart[0] = 0;
+}
+
+/*** GridBroadphase *******************************************************************/
+GridBroadphase::GridBroadphase(glm::vec2 min, glm::vec2 max, float cellSize)
+    : _bins(min, max, cellSize)
+{
+}
+
+const char* GridBroadphase::name() const
+{
+    return "grid";
+}
+
+void GridBroadphase::findPairs(const uint32_t* bodies, size_t count, const glm::vec2* pos, const glm::vec2* size, ArenaVector<BodyPair>& pairs)
+{
+    _bins.fill(bodies, count, pos, size);
+
+    /*
+     * A pair sharing several cells is only reported from the cell holding the
+     * top-left corner of the intersection of both boxes.
+     */
+    for (int cell = 0; cell < _bins.cellCount(); cell++)
+    {
+        auto end = _bins.end(cell);
+        for (auto i = _bins.begin(cell); i < end; i++)
+        {
+            auto a = *i;
+            for (auto j = i + 1; j < end; j++)
+            {
+                auto b = *j;
+                auto lo = glm::max(pos[a] - size[a] / 2.0f, pos[b] - size[b] / 2.0f);
+                if (_bins.cell(lo) == cell)
+                {
+                    pairs.push_back(makePair(a, b));
+                }
+            }
+        }
+    }
+}
+
+/*** SweepAndPruneBroadphase **********************************************************/
+const char* SweepAndPruneBroadphase::name() const
+{
+    return "sap";
+}
+
+void SweepAndPruneBroadphase::findPairs(const uint32_t* bodies, size_t count, const glm::vec2* pos, const glm::vec2* size, ArenaVector<BodyPair>& pairs)
+{
+    /* Track membership changes: drop despawned bodies, append new ones */
+    _tick++;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (bodies[i] >= _stamp.size())
+        {
+            _stamp.resize(bodies[i] + 1, 0);
+        }
+        _stamp[bodies[i]] = _tick;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < _intervals.size(); i++)
+    {
+        auto& interval = _intervals[i];
+        if (_stamp[interval.body] == _tick)
+        {
+            _stamp[interval.body] = 0; /* known */
+            _intervals[kept++] = interval;
+        }
+    }
+    _intervals.resize(kept);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (_stamp[bodies[i]] == _tick)
+        {
+            _intervals.push_back({0.0f, 0.0f, bodies[i]});
+        }
+    }
+
+    /* Update the intervals and repair the order */
+    for (auto& interval : _intervals)
+    {
+        interval.min = pos[interval.body].x - size[interval.body].x / 2.0f;
+        interval.max = pos[interval.body].x + size[interval.body].x / 2.0f;
+    }
+
+    for (size_t i = 1; i < _intervals.size(); i++)
+    {
+        auto interval = _intervals[i];
+        auto j = i;
+        while (j > 0 && _intervals[j - 1].min > interval.min)
+        {
+            _intervals[j] = _intervals[j - 1];
+            j--;
+        }
+        _intervals[j] = interval;
+    }
+
+    /* Sweep */
+    for (size_t i = 0; i < _intervals.size(); i++)
+    {
+        const auto& a = _intervals[i];
+        for (size_t j = i + 1; j < _intervals.size() && _intervals[j].min < a.max; j++)
+        {
+            const auto& b = _intervals[j];
+            if (std::abs(pos[b.body].y - pos[a.body].y) < (size[a.body].y + size[b.body].y) / 2.0f)
+            {
+                pairs.push_back(makePair(a.body, b.body));
+            }
+        }
+    }
+}
+
+/*** StaticGrid *********************************************************************/
+StaticGrid::StaticGrid(glm::vec2 min, glm::vec2 max, float cellSize)
+    : _bins(min, max, cellSize)
+{
+}
+
+void StaticGrid::build(const uint32_t* statics, size_t count, const glm::vec2* pos, const glm::vec2* size)
+{
+    _bins.fill(statics, count, pos, size);
+    _stamp.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (statics[i] >= _stamp.size())
+        {
+            _stamp.resize(statics[i] + 1, 0);
+        }
+    }
+    _query = 0;
+}
+
+void StaticGrid::findPairs(const uint32_t* bodies, size_t count, const glm::vec2* pos, const glm::vec2* size, ArenaVector<BodyPair>& pairs)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        auto body = bodies[i];
+        query(pos[body] - size[body] / 2.0f,
+              pos[body] + size[body] / 2.0f,
+              [body, &pairs](uint32_t other)
+              {
+                  pairs.push_back(makePair(body, other));
+              });
+    }
+}
+
+/*** Factory **************************************************************************/
+std::unique_ptr<Broadphase> createBroadphase(const char* name)
+{
+    if (!strcmp(name, "brute"))
+    {
+        return std::make_unique<BruteForceBroadphase>();
+    }
+    else if (!strcmp(name, "grid"))
+    {
+        /* The playfield is 1.77x1.0 centered on the origin, walls stick out by 0.1 */
+        return std::make_unique<GridBroadphase>(glm::vec2 {-1.0f, -0.6f}, glm::vec2 {1.0f, 0.6f}, 0.1f);
+    }
+    else if (!strcmp(name, "sap"))
+    {
+        return std::make_unique<SweepAndPruneBroadphase>();
+    }
+    return nullptr;
+}
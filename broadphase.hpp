@@ -0,0 +1,163 @@
+#pragma once
+
+#include "arena.hpp"
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+struct BodyPair
+{
+    uint32_t a; /* always a < b */
+    uint32_t b;
+};
+
+/*
+ * Finds the pairs of bodies whose bounding boxes may overlap.
+ *
+ * bodies lists the entity slots taking part in collisions, pos and size are
+ * indexed by slot. Every candidate pair is reported exactly once; the
+ * narrowphase still has to do the exact test.
+ */
+class Broadphase
+{
+public:
+    virtual ~Broadphase() = default;
+    virtual const char* name() const = 0;
+    virtual void findPairs(const uint32_t* bodies, size_t count, const glm::vec2* pos, const glm::vec2* size, ArenaVector<BodyPair>& pairs) = 0;
+};
+
+/* Tests every pair, O(n²). Fine for the standard match. */
+class BruteForceBroadphase : public Broadphase
+{
+public:
+    const char* name() const override;
+    void findPairs(const uint32_t* bodies, size_t count, const glm::vec2* pos, const glm::vec2* size, ArenaVector<BodyPair>& pairs) override;
+};
+
+/*
+ * Bodies binned into the cells of a uniform grid over a fixed region, with a
+ * counting sort. A body is binned into every cell it touches; bodies outside
+ * the region are clamped into the border cells.
+ */
+class GridBins
+{
+public:
+    GridBins(glm::vec2 min, glm::vec2 max, float cellSize);
+    void fill(const uint32_t* bodies, size_t count, const glm::vec2* pos, const glm::vec2* size);
+    int cellCount() const;
+    int cell(glm::vec2 p) const;
+    const uint32_t* begin(int cell) const;
+    const uint32_t* end(int cell) const;
+
+    /* Calls f(cell) for each cell overlapped by the box [lo, hi] */
+    template <typename F>
+    void forEachCell(glm::vec2 lo, glm::vec2 hi, F&& f) const
+    {
+        for (int y = row(lo.y); y <= row(hi.y); y++)
+        {
+            for (int x = column(lo.x); x <= column(hi.x); x++)
+            {
+                f(y * _columns + x);
+            }
+        }
+    }
+
+private:
+    glm::vec2 _min;
+    float _invCellSize;
+    int _columns;
+    int _rows;
+    std::vector<uint32_t> _cellStart; /* prefix sums of cell populations, one extra entry */
+    std::vector<uint32_t> _cellEntries;
+
+    int column(float x) const;
+    int row(float y) const;
+};
+
+/* Uniform spatial hash grid, rebuilt every tick */
+class GridBroadphase : public Broadphase
+{
+public:
+    GridBroadphase(glm::vec2 min, glm::vec2 max, float cellSize);
+    const char* name() const override;
+    void findPairs(const uint32_t* bodies, size_t count, const glm::vec2* pos, const glm::vec2* size, ArenaVector<BodyPair>& pairs) override;
+
+private:
+    GridBins _bins;
+};
+
+/*
+ * Incremental sweep-and-prune along the x axis.
+ *
+ * The order of the bodies by left edge is kept between ticks and repaired
+ * with an insertion sort, which is close to linear since bodies barely move
+ * from one tick to the next.
+ */
+class SweepAndPruneBroadphase : public Broadphase
+{
+public:
+    const char* name() const override;
+    void findPairs(const uint32_t* bodies, size_t count, const glm::vec2* pos, const glm::vec2* size, ArenaVector<BodyPair>& pairs) override;
+
+private:
+    struct Interval
+    {
+        float min;
+        float max;
+        uint32_t body;
+    };
+
+    std::vector<Interval> _intervals; /* sorted by min */
+    std::vector<uint32_t> _stamp;     /* per slot: tick it was last seen, to track membership */
+    uint32_t _tick = 0;
+};
+
+/*
+ * Acceleration structure for static geometry, built once. Finds the pairs
+ * between moving bodies and static ones, so static bodies never have to go
+ * through the per-tick broadphase and are never tested against each other.
+ */
+class StaticGrid
+{
+public:
+    StaticGrid(glm::vec2 min, glm::vec2 max, float cellSize);
+    void build(const uint32_t* statics, size_t count, const glm::vec2* pos, const glm::vec2* size);
+    void findPairs(const uint32_t* bodies, size_t count, const glm::vec2* pos, const glm::vec2* size, ArenaVector<BodyPair>& pairs);
+
+    /* Calls f(body) once for each static body whose cells overlap the box [lo, hi] */
+    template <typename F>
+    void query(glm::vec2 lo, glm::vec2 hi, F&& f)
+    {
+        /* A static body spanning several cells must be reported once per query */
+        if (++_query == 0)
+        {
+            std::fill(_stamp.begin(), _stamp.end(), 0);
+            _query = 1;
+        }
+
+        _bins.forEachCell(lo,
+                          hi,
+                          [this, &f](int cell)
+                          {
+                              for (auto i = _bins.begin(cell); i < _bins.end(cell); i++)
+                              {
+                                  if (_stamp[*i] != _query)
+                                  {
+                                      _stamp[*i] = _query;
+                                      f(*i);
+                                  }
+                              }
+                          });
+    }
+
+private:
+    GridBins _bins;
+    std::vector<uint32_t> _stamp; /* per static slot: last query that reported it */
+    uint32_t _query = 0;
+};
+
+/* Returns nullptr for an unknown name. Known names: "brute", "grid", "sap". */
+std::unique_ptr<Broadphase> createBroadphase(const char* name);
@@ -0,0 +1,191 @@
+#include "entities.hpp"
+
+#include <assert.h>
+
+static constexpr uint32_t INDEX_MASK = (1u << Entities::INDEX_BITS) - 1;
+static constexpr uint32_t GENERATION_MASK = ~0u >> Entities::INDEX_BITS;
+
+Entities::Entities(size_t capacity)
+    : _count(0),
+      _capacity(capacity),
+      _pos(capacity),
+      _size(capacity),
+      _v(capacity),
+      _color(capacity),
+      _flags(capacity),
+      _behavior(capacity),
+      _idleTicks(capacity),
+      _generation(capacity, 0),
+      _names(capacity)
+{
+    assert(capacity <= MAX_CAPACITY);
+    _free.reserve(capacity);
+}
+
+Entities::Handle Entities::spawn(glm::vec2 pos, glm::vec2 size, glm::vec3 color, unsigned flags, Behavior behavior)
+{
+    size_t index;
+    if (!_free.empty())
+    {
+        index = _free.back();
+        _free.pop_back();
+    }
+    else if (_count < _capacity)
+    {
+        index = _count++;
+    }
+    else
+    {
+        return NONE;
+    }
+
+    _pos[index] = pos;
+    _size[index] = size;
+    _v[index] = {0.0f, 0.0f};
+    _color[index] = color;
+    _flags[index] = flags;
+    _behavior[index] = behavior;
+    _idleTicks[index] = 0;
+    _generation[index] = (_generation[index] + 1) & GENERATION_MASK;
+    return handle(index);
+}
+
+void Entities::despawn(Handle entity)
+{
+    if (!alive(entity))
+    {
+        return;
+    }
+
+    auto index = this->index(entity);
+    _v[index] = {0.0f, 0.0f};
+    _flags[index] = 0;
+    _behavior[index] = {};
+    _names[index].clear();
+    _generation[index] = (_generation[index] + 1) & GENERATION_MASK;
+    _free.push_back(index);
+}
+
+bool Entities::alive(Handle entity) const
+{
+    auto index = entity.value & INDEX_MASK;
+    auto generation = entity.value >> INDEX_BITS;
+    return (generation & 1) && index < _count && _generation[index] == generation;
+}
+
+size_t Entities::index(Handle entity) const
+{
+    return entity.value & INDEX_MASK;
+}
+
+Entities::Handle Entities::handle(size_t index) const
+{
+    return {static_cast<uint32_t>(index) | (_generation[index] << INDEX_BITS)};
+}
+
+void Entities::clear()
+{
+    for (size_t i = 0; i < _count; i++)
+    {
+        _flags[i] = 0;
+        _v[i] = {0.0f, 0.0f};
+        _behavior[i] = {};
+        _names[i].clear();
+        if (_generation[i] & 1)
+        {
+            _generation[i] = (_generation[i] + 1) & GENERATION_MASK;
+        }
+    }
+    _count = 0;
+    _free.clear();
+}
+
+size_t Entities::count() const
+{
+    return _count;
+}
+
+size_t Entities::live() const
+{
+    return _count - _free.size();
+}
+
+size_t Entities::capacity() const
+{
+    return _capacity;
+}
+
+glm::vec2* Entities::pos()
+{
+    return _pos.data();
+}
+
+const glm::vec2* Entities::pos() const
+{
+    return _pos.data();
+}
+
+glm::vec2* Entities::size()
+{
+    return _size.data();
+}
+
+const glm::vec2* Entities::size() const
+{
+    return _size.data();
+}
+
+glm::vec2* Entities::v()
+{
+    return _v.data();
+}
+
+const glm::vec2* Entities::v() const
+{
+    return _v.data();
+}
+
+glm::vec3* Entities::color()
+{
+    return _color.data();
+}
+
+const glm::vec3* Entities::color() const
+{
+    return _color.data();
+}
+
+unsigned* Entities::flags()
+{
+    return _flags.data();
+}
+
+const unsigned* Entities::flags() const
+{
+    return _flags.data();
+}
+
+Behavior* Entities::behavior()
+{
+    return _behavior.data();
+}
+
+const Behavior* Entities::behavior() const
+{
+    return _behavior.data();
+}
+
+uint16_t* Entities::idleTicks()
+{
+    return _idleTicks.data();
+}
+
+const uint16_t* Entities::idleTicks() const
+{
+    return _idleTicks.data();
+}
+
+std::string& Entities::name(Handle entity)
+{
+    return _names[index(entity)];
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "aligned.hpp"
+#include "behavior.hpp"
+#include <glm/glm.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*
+ * Structure-of-arrays entity pool.
+ *
+ * Hot per-tick data (position, size, velocity, color, flags, behavior) lives
+ * in dense, cache-line aligned arrays indexed by slot. Names are only used for
+ * debugging, so they are kept in a separate cold array and never pollute the
+ * integrate and render loops.
+ *
+ * All storage is allocated up front for a fixed capacity. Despawned slots go
+ * to a free list and are reused by the next spawn, so spawning and despawning
+ * are O(1) and never allocate. A dead slot has no flags and no velocity, so the
+ * loops can walk [0, count()) without checking liveness.
+ *
+ * Entities are referred to by 32-bit generational handles: the low bits are
+ * the slot index, the high bits the slot's generation. The generation is
+ * bumped on both spawn and despawn, so it is odd while the slot is alive and
+ * a stale handle is detected with a single compare.
+ */
+class Entities
+{
+public:
+    static constexpr auto DISPLAY = 1;
+    static constexpr auto PHYSICS = 2;
+
+    /* Body type of PHYSICS entities, dynamic unless flagged otherwise */
+    static constexpr auto STATIC = 4;    /* never moves */
+    static constexpr auto KINEMATIC = 8; /* moved by its controller only */
+    static constexpr auto SLEEPING = 16; /* at rest, maintained by the simulation */
+    static constexpr auto BULLET = 32;   /* fast dynamic body, swept against the others every tick */
+
+    static constexpr auto INDEX_BITS = 20;
+    static constexpr auto MAX_CAPACITY = size_t {1} << INDEX_BITS;
+
+    struct Handle
+    {
+        uint32_t value;
+
+        bool operator==(Handle other) const
+        {
+            return value == other.value;
+        }
+
+        bool operator!=(Handle other) const
+        {
+            return value != other.value;
+        }
+    };
+
+    static constexpr Handle NONE = {0}; /* even generation, never alive */
+
+    explicit Entities(size_t capacity);
+
+    Handle spawn(glm::vec2 pos, glm::vec2 size, glm::vec3 color, unsigned flags, Behavior behavior = {});
+    void despawn(Handle entity);
+    bool alive(Handle entity) const;
+    size_t index(Handle entity) const;
+    Handle handle(size_t index) const;
+    void clear();
+
+    size_t count() const; /* one past the highest slot ever used */
+    size_t live() const;
+    size_t capacity() const;
+
+    glm::vec2* pos();
+    const glm::vec2* pos() const;
+    glm::vec2* size();
+    const glm::vec2* size() const;
+    glm::vec2* v();
+    const glm::vec2* v() const;
+    glm::vec3* color();
+    const glm::vec3* color() const;
+    unsigned* flags();
+    const unsigned* flags() const;
+    Behavior* behavior();
+    const Behavior* behavior() const;
+    uint16_t* idleTicks();
+    const uint16_t* idleTicks() const;
+
+    std::string& name(Handle entity);
+
+private:
+    size_t _count;
+    size_t _capacity;
+
+    /* hot */
+    AlignedVector<glm::vec2> _pos; /* center */
+    AlignedVector<glm::vec2> _size;
+    AlignedVector<glm::vec2> _v;
+    AlignedVector<glm::vec3> _color;
+    AlignedVector<unsigned> _flags;
+    AlignedVector<Behavior> _behavior;
+    AlignedVector<uint16_t> _idleTicks; /* consecutive ticks at rest */
+
+    /* cold */
+    std::vector<uint32_t> _generation;
+    std::vector<uint32_t> _free; /* stack of free slots below _count */
+    std::vector<std::string> _names;
+};
@@ -0,0 +1,137 @@
+#include "env.h"
+
+#include "aligned.hpp"
+#include "batchsim.hpp"
+#include <new>
+#include <string.h>
+#include <vector>
+
+static constexpr int AGENT = 0;
+static constexpr int OPPONENT = 1;
+
+struct PongEnv
+{
+    PongEnv(size_t n, BatchSim::Controller opponent)
+        : sim(n, 0, BatchSim::EXTERNAL, opponent),
+          rewards(sim.lanes()),
+          dones(sim.lanes()),
+          margins(sim.lanes())
+    {
+    }
+
+    BatchSim sim;
+    AlignedVector<float> rewards;
+    std::vector<uint8_t> dones;
+    std::vector<int32_t> margins; /* agent points minus opponent points at the last point of each match */
+};
+
+PongEnv* env_create(size_t n)
+{
+    return env_create_opponent(n, "normal");
+}
+
+PongEnv* env_create_opponent(size_t n, const char* opponent)
+{
+    if (!opponent)
+    {
+        return nullptr;
+    }
+    if (!strcmp(opponent, "idle"))
+    {
+        return new (std::nothrow) PongEnv(n, BatchSim::IDLE);
+    }
+    if (!strcmp(opponent, "cpu"))
+    {
+        return new (std::nothrow) PongEnv(n, BatchSim::CPU);
+    }
+    auto skill = findBotSkill(opponent);
+    if (!skill)
+    {
+        return nullptr;
+    }
+    auto env = new (std::nothrow) PongEnv(n, BatchSim::BOT);
+    if (env)
+    {
+        env->sim.setSkill(OPPONENT, *skill);
+    }
+    return env;
+}
+
+void env_destroy(PongEnv* env)
+{
+    delete env;
+}
+
+void env_reset(PongEnv* env, uint64_t seed)
+{
+    env->sim.restart(Rng(seed));
+    size_t lanes = env->sim.lanes();
+    memset(env->rewards.data(), 0, lanes * sizeof(float));
+    memset(env->dones.data(), 0, lanes);
+    memset(env->margins.data(), 0, lanes * sizeof(int32_t));
+}
+
+/* Only the matches that scored touch the rewards and dones, the others keep their zeros */
+void env_step(PongEnv* env, const float* actions)
+{
+    auto& sim = env->sim;
+    size_t count;
+    auto scored = sim.scored(&count);
+    for (size_t i = 0; i < count; i++)
+    {
+        env->rewards[scored[i]] = 0.0f;
+        env->dones[scored[i]] = 0;
+    }
+
+    sim.setActions(AGENT, actions);
+    sim.tick();
+    sim.setActions(AGENT, nullptr);
+
+    scored = sim.scored(&count);
+    auto agent = sim.scores(AGENT);
+    auto opponent = sim.scores(OPPONENT);
+    for (size_t i = 0; i < count; i++)
+    {
+        auto lane = scored[i];
+        int32_t margin = agent[lane] - opponent[lane];
+        env->rewards[lane] = static_cast<float>(margin - env->margins[lane]);
+        env->dones[lane] = 1;
+        env->margins[lane] = margin;
+    }
+}
+
+size_t env_size(const PongEnv* env)
+{
+    return env->sim.lanes();
+}
+
+const float* env_observation(const PongEnv* env, int feature)
+{
+    switch (feature)
+    {
+    case PONG_ENV_BALL_X:
+        return env->sim.ballX();
+    case PONG_ENV_BALL_Y:
+        return env->sim.ballY();
+    case PONG_ENV_BALL_VX:
+        return env->sim.ballVX();
+    case PONG_ENV_BALL_VY:
+        return env->sim.ballVY();
+    case PONG_ENV_PADDLE_Y:
+        return env->sim.paddleY(AGENT);
+    case PONG_ENV_OPPONENT_Y:
+        return env->sim.paddleY(OPPONENT);
+    default:
+        return nullptr;
+    }
+}
+
+const float* env_rewards(const PongEnv* env)
+{
+    return env->rewards.data();
+}
+
+const uint8_t* env_dones(const PongEnv* env)
+{
+    return env->dones.data();
+}
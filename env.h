@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Vectorized environment for agents written in other languages: a C ABI over
+ * a BatchSim, for a shared library loadable from ctypes, cffi, Julia, etc.
+ *
+ * An environment holds n matches played by the rules of the game. The agent
+ * plays the left paddle, like the player of the game, against a computer
+ * player on the right. Every env_step() moves the agent's paddles by one
+ * action per match, then advances all the matches by one tick (1/60 s).
+ *
+ * Nothing is copied in or out: the observations, rewards and dones are
+ * pointers into the simulation, one array per value with one entry per match,
+ * and stay valid until env_destroy(). env_step() reads the actions where the
+ * caller keeps them. Stepping does not allocate.
+ *
+ * The field spans [-0.885, 0.885] along x and [-0.5, 0.5] along y, y pointing
+ * down. A point ends an episode: its match reports a reward and a done, and
+ * its ball waits at the center to be served at the next step, like the game.
+ */
+
+#ifdef _WIN32
+#    ifdef PONGENV_BUILD
+#        define PONGENV_API __declspec(dllexport)
+#    else
+#        define PONGENV_API __declspec(dllimport)
+#    endif
+#else
+#    define PONGENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct PongEnv PongEnv;
+
+/* Observations, by env_observation() */
+enum PongEnvFeature
+{
+    PONG_ENV_BALL_X,
+    PONG_ENV_BALL_Y,
+    PONG_ENV_BALL_VX,
+    PONG_ENV_BALL_VY,
+    PONG_ENV_PADDLE_Y,   /* of the agent */
+    PONG_ENV_OPPONENT_Y, /* of the computer player */
+    PONG_ENV_FEATURES,
+};
+
+/*
+ * At least n matches against the normal bot, seeded with 0. n is rounded up
+ * to a multiple of 8, env_size() is the number of matches and of entries in
+ * every array. NULL when the environment can not be allocated; the library
+ * is built without exceptions, so running out of memory for its arrays
+ * still aborts.
+ */
+PONGENV_API PongEnv* env_create(size_t n);
+
+/* Same against "idle", "cpu" or a bot skill ("easy", "normal", "hard", "perfect"), NULL if unknown or NULL */
+PONGENV_API PongEnv* env_create_opponent(size_t n, const char* opponent);
+
+PONGENV_API void env_destroy(PongEnv* env);
+
+/* Every match back to 0-0 with the ball at the center, drawing from seed */
+PONGENV_API void env_reset(PongEnv* env, uint64_t seed);
+
+/* actions has env_size() entries in [-1, 1], the share of the paddle speed to move by along y */
+PONGENV_API void env_step(PongEnv* env, const float* actions);
+
+PONGENV_API size_t env_size(const PongEnv* env);
+
+/* NULL for an unknown feature */
+PONGENV_API const float* env_observation(const PongEnv* env, int feature);
+
+/* 1 when the agent scored at the last step, -1 when the opponent did, 0 otherwise */
+PONGENV_API const float* env_rewards(const PongEnv* env);
+
+/* 1 when a point was scored at the last step, 0 otherwise */
+PONGENV_API const uint8_t* env_dones(const PongEnv* env);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,276 @@
+#include "eventsim.hpp"
+
+#include "rules.hpp"
+#include "world.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+
+/* Ball center positions on contact */
+static constexpr double BALL_MAX_Y = (GAME_HEIGHT / 2.0) - (BALL_SIZE / 2.0);
+static constexpr double SCORE_X = (GAME_WIDTH / 2.0) - (BALL_SIZE / 2.0);
+static constexpr double PADDLE_X = (GAME_WIDTH / 2.0) - PADDLE_INSET;
+static constexpr double PADDLE_MAX_Y = (GAME_HEIGHT / 2.0) - (PADDLE_HEIGHT / 2.0);
+
+/* Paddle grown by the half size of the ball, so that the ball is a point */
+static constexpr double PADDLE_EXTENT_X = (PADDLE_WIDTH + BALL_SIZE) / 2.0;
+static constexpr double PADDLE_EXTENT_Y = (PADDLE_HEIGHT + BALL_SIZE) / 2.0;
+
+/*
+ * Time until the ball, moving by (vx, vy) relative to the paddle, starts
+ * touching it, in the manner of sweep(). Touches the face if axis is 0, an
+ * end if it is 1.
+ */
+static bool sweepPaddle(double dx, double dy, double vx, double vy, double& t, int& axis)
+{
+    const double gap[] = {dx, dy};
+    const double v[] = {vx, vy};
+    const double extent[] = {PADDLE_EXTENT_X, PADDLE_EXTENT_Y};
+    double tEnter = -INFINITY;
+    double tExit = INFINITY;
+    for (int i = 0; i < 2; i++)
+    {
+        if (v[i] == 0.0)
+        {
+            if (std::fabs(gap[i]) >= extent[i])
+            {
+                return false;
+            }
+            continue;
+        }
+
+        double t1 = (-extent[i] - gap[i]) / v[i];
+        double t2 = (extent[i] - gap[i]) / v[i];
+        double tNear = std::min(t1, t2);
+        if (tNear > tEnter)
+        {
+            tEnter = tNear;
+            axis = i;
+        }
+        tExit = std::min(tExit, std::max(t1, t2));
+    }
+
+    /* Not a hit at 0 either: a paddle faster than the ball it just pushed would hit it forever */
+    if (tEnter >= tExit || tEnter <= 0.0)
+    {
+        return false;
+    }
+    t = tEnter;
+    return true;
+}
+
+EventSim::EventSim(uint64_t seed, Controller left, Controller right)
+    : _state {},
+      _controllers {left, right},
+      _rng(seed),
+      _events(0)
+{
+    serve();
+}
+
+/* Same draw as the SERVE control of the game */
+void EventSim::serve()
+{
+    glm::vec2 v;
+    do
+    {
+        v = glm::vec2 {(_rng.fnext() * 2.0f) - 1.0f, (_rng.fnext() * 2.0f) - 1.0f};
+    } while (v.x < 0.01f);
+    v = glm::normalize(v) * BALL_SPEED;
+
+    _state.ballX = 0.0;
+    _state.ballY = 0.0;
+    _state.ballVX = v.x;
+    _state.ballVY = v.y;
+    control(0);
+    control(1);
+}
+
+EventSim::Event EventSim::step()
+{
+    auto event = next();
+    move(event.time);
+    process(event);
+    _events++;
+    return event;
+}
+
+/* Process every event up to time() + duration, then move to exactly that time */
+void EventSim::advance(double duration)
+{
+    auto end = _state.time + duration;
+    while (true)
+    {
+        auto event = next();
+        if (_state.time + event.time > end)
+        {
+            move(end - _state.time);
+            _state.time = end;
+            break;
+        }
+        move(event.time);
+        process(event);
+        _events++;
+    }
+}
+
+/* Returns the winner, or -1 if nobody reached points within timeLimit seconds */
+int EventSim::playMatch(int points, double timeLimit)
+{
+    auto end = _state.time + timeLimit;
+    while (_state.time < end)
+    {
+        auto event = step();
+        if (event.type == SCORE && _state.scores[event.side] >= points)
+        {
+            return event.side;
+        }
+    }
+    return -1;
+}
+
+const EventSim::State& EventSim::state() const
+{
+    return _state;
+}
+
+uint64_t EventSim::events() const
+{
+    return _events;
+}
+
+/* Time until the earliest event, the state itself is left untouched */
+EventSim::Event EventSim::next() const
+{
+    const auto& s = _state;
+    Event event {INFINITY, NONE, -1};
+    auto consider = [&event](double dt, EventType type, int side)
+    {
+        if (dt < event.time)
+        {
+            event = {std::max(dt, 0.0), type, side};
+        }
+    };
+
+    if (s.ballVY != 0.0)
+    {
+        consider((std::copysign(BALL_MAX_Y, s.ballVY) - s.ballY) / s.ballVY, WALL_BOUNCE, -1);
+    }
+    if (s.ballVX != 0.0)
+    {
+        consider((std::copysign(SCORE_X, s.ballVX) - s.ballX) / s.ballVX, SCORE, s.ballVX < 0.0);
+    }
+
+    for (int side = 0; side < 2; side++)
+    {
+        auto v = s.paddleV[side];
+        double t = 0.0;
+        int axis = 0;
+        if (sweepPaddle(s.ballX - (side ? PADDLE_X : -PADDLE_X), s.ballY - s.paddleY[side], s.ballVX, s.ballVY - v, t, axis))
+        {
+            consider(t, axis ? PADDLE_END : PADDLE_BOUNCE, side);
+        }
+
+        if (v != 0.0)
+        {
+            consider((std::copysign(PADDLE_MAX_Y, v) - s.paddleY[side]) / v, PADDLE_STOP, side);
+        }
+
+        /* CPU paddles change direction when the ball crosses their height */
+        auto dy = s.ballY - s.paddleY[side];
+        auto dv = s.ballVY - v;
+        if (_controllers[side] == CPU && dy * dv < 0.0)
+        {
+            consider(-dy / dv, PADDLE_TURN, side);
+        }
+    }
+    return event;
+}
+
+void EventSim::move(double dt)
+{
+    auto& s = _state;
+    s.time += dt;
+    s.ballX += s.ballVX * dt;
+    s.ballY += s.ballVY * dt;
+    for (int side = 0; side < 2; side++)
+    {
+        s.paddleY[side] += s.paddleV[side] * dt;
+    }
+}
+
+/*
+ * Snaps the state onto the event to avoid drift, then applies its effect. Like
+ * World, a bounce leaves the ball World::SWEEP_SKIN away from what it hit.
+ */
+void EventSim::process(const Event& event)
+{
+    auto& s = _state;
+    switch (event.type)
+    {
+    case NONE:
+        break;
+    case WALL_BOUNCE:
+        s.ballY = std::copysign(BALL_MAX_Y - World::SWEEP_SKIN, s.ballVY);
+        s.ballVY = -s.ballVY;
+        break;
+    case PADDLE_BOUNCE:
+        s.ballX = (event.side ? PADDLE_X : -PADDLE_X) - std::copysign(PADDLE_EXTENT_X + World::SWEEP_SKIN, s.ballVX);
+        s.ballVX = -s.ballVX;
+        break;
+    case PADDLE_END:
+        s.ballY = s.paddleY[event.side] - std::copysign(PADDLE_EXTENT_Y + World::SWEEP_SKIN, s.ballVY - s.paddleV[event.side]);
+        s.ballVY = -s.ballVY;
+        break;
+    case SCORE:
+        s.scores[event.side]++;
+        serve();
+        return;
+    case PADDLE_STOP:
+        s.paddleY[event.side] = std::copysign(PADDLE_MAX_Y, s.paddleV[event.side]);
+        s.paddleV[event.side] = 0.0;
+        break;
+    case PADDLE_TURN:
+        s.paddleY[event.side] = s.ballY;
+        break;
+    }
+    control(0);
+    control(1);
+}
+
+/*
+ * Continuous version of Behavior::CPU: chase the ball while it comes towards
+ * the paddle, back away from it otherwise. Once level with the ball the paddle
+ * follows it as well as its speed allows.
+ */
+void EventSim::control(int side)
+{
+    auto& s = _state;
+    auto& v = s.paddleV[side];
+    if (_controllers[side] == IDLE)
+    {
+        v = 0.0;
+        return;
+    }
+
+    bool incoming = side ? s.ballVX > 0.0 : s.ballVX < 0.0;
+    auto dy = s.ballY - s.paddleY[side];
+    if (dy != 0.0)
+    {
+        v = std::copysign(PADDLE_SPEED, incoming ? dy : -dy);
+    }
+    else if (incoming)
+    {
+        v = std::clamp(s.ballVY, -static_cast<double>(PADDLE_SPEED), static_cast<double>(PADDLE_SPEED));
+    }
+    else
+    {
+        v = s.ballVY == 0.0 ? 0.0 : std::copysign(PADDLE_SPEED, -s.ballVY);
+    }
+
+    /* Walls keep the paddle on the field */
+    if (std::fabs(s.paddleY[side]) >= PADDLE_MAX_Y && v * s.paddleY[side] > 0.0)
+    {
+        v = 0.0;
+    }
+}
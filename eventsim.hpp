@@ -0,0 +1,79 @@
+#pragma once
+
+#include "rng.hpp"
+#include <stdint.h>
+
+/*
+ * Event-driven simulation of a match, without rendering nor fixed ticks.
+ *
+ * Between two events the ball moves in a straight line and the paddles at a
+ * constant speed, so instead of stepping at FPS the time of the next event is
+ * solved for and the whole match jumps straight to it. Events are the ball
+ * reaching a bounce wall, a paddle or a score wall, a paddle reaching the end
+ * of its course and a CPU paddle crossing the height of the ball, after which
+ * its policy changes direction.
+ *
+ * Positions at event boundaries match what World computes. The exception is a
+ * CPU paddle which caught up with the ball: here it follows the ball exactly,
+ * while the fixed step one dithers around it by PADDLE_SPEED * dT, and which
+ * side of the ball it is on when the ball turns back decides where it goes.
+ *
+ * Side 0 is the left paddle, side 1 the right one. After a point the ball is
+ * served again right away.
+ */
+class EventSim
+{
+public:
+    enum Controller : uint8_t
+    {
+        IDLE, /* never moves, what a keyboard paddle does without input */
+        CPU,  /* same policy as Behavior::CPU */
+    };
+
+    enum EventType : uint8_t
+    {
+        NONE,
+        WALL_BOUNCE,
+        PADDLE_BOUNCE, /* ball hit the face of a paddle */
+        PADDLE_END,    /* ball hit the top or bottom of a paddle */
+        SCORE,
+        PADDLE_STOP, /* paddle reached the end of its course */
+        PADDLE_TURN, /* CPU paddle reached the height of the ball */
+    };
+
+    struct Event
+    {
+        double time;
+        EventType type;
+        int side; /* paddle involved, or player who scored */
+    };
+
+    struct State
+    {
+        double time;
+        double ballX, ballY;
+        double ballVX, ballVY;
+        double paddleY[2];
+        double paddleV[2];
+        int scores[2];
+    };
+
+    EventSim(uint64_t seed, Controller left, Controller right);
+    void serve();
+    Event step();
+    void advance(double duration);
+    int playMatch(int points, double timeLimit);
+    const State& state() const;
+    uint64_t events() const;
+
+private:
+    State _state;
+    Controller _controllers[2];
+    Rng _rng;
+    uint64_t _events;
+
+    Event next() const;
+    void move(double dt);
+    void process(const Event& event);
+    void control(int side);
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Q16.16 fixed-point number.
+ *
+ * Every operation is integer arithmetic on the raw value, so results are the
+ * same on every compiler, optimization level and target, emscripten included.
+ * Products and quotients go through 64 bits, products round towards negative
+ * infinity and quotients towards zero. There is no overflow check, the
+ * playfield is far from the +-32768 range.
+ *
+ * fromFloat() is for constants: a float known at compile time converts the
+ * same way everywhere.
+ */
+struct Fixed
+{
+    static constexpr int FRACTION_BITS = 16;
+    static constexpr int32_t ONE = 1 << FRACTION_BITS;
+
+    int32_t raw;
+
+    static constexpr Fixed fromRaw(int32_t raw)
+    {
+        return Fixed {raw};
+    }
+
+    static constexpr Fixed fromInt(int32_t value)
+    {
+        return Fixed {value * ONE};
+    }
+
+    static constexpr Fixed fromFloat(float value)
+    {
+        return Fixed {static_cast<int32_t>((value * ONE) + (value < 0.0f ? -0.5f : 0.5f))};
+    }
+
+    constexpr float toFloat() const
+    {
+        return static_cast<float>(raw) / ONE;
+    }
+
+    constexpr Fixed operator-() const
+    {
+        return Fixed {-raw};
+    }
+
+    constexpr Fixed operator+(Fixed other) const
+    {
+        return Fixed {raw + other.raw};
+    }
+
+    constexpr Fixed operator-(Fixed other) const
+    {
+        return Fixed {raw - other.raw};
+    }
+
+    constexpr Fixed operator*(Fixed other) const
+    {
+        return Fixed {static_cast<int32_t>((static_cast<int64_t>(raw) * other.raw) >> FRACTION_BITS)};
+    }
+
+    constexpr Fixed operator/(Fixed other) const
+    {
+        return Fixed {static_cast<int32_t>((static_cast<int64_t>(raw) * ONE) / other.raw)};
+    }
+
+    Fixed& operator+=(Fixed other)
+    {
+        raw += other.raw;
+        return *this;
+    }
+
+    Fixed& operator-=(Fixed other)
+    {
+        raw -= other.raw;
+        return *this;
+    }
+
+    constexpr bool operator==(Fixed other) const
+    {
+        return raw == other.raw;
+    }
+
+    constexpr bool operator!=(Fixed other) const
+    {
+        return raw != other.raw;
+    }
+
+    constexpr bool operator<(Fixed other) const
+    {
+        return raw < other.raw;
+    }
+
+    constexpr bool operator>(Fixed other) const
+    {
+        return raw > other.raw;
+    }
+
+    constexpr bool operator<=(Fixed other) const
+    {
+        return raw <= other.raw;
+    }
+
+    constexpr bool operator>=(Fixed other) const
+    {
+        return raw >= other.raw;
+    }
+};
+
+struct FixedVec2
+{
+    Fixed x;
+    Fixed y;
+
+    constexpr FixedVec2 operator+(FixedVec2 other) const
+    {
+        return FixedVec2 {x + other.x, y + other.y};
+    }
+
+    constexpr FixedVec2 operator-(FixedVec2 other) const
+    {
+        return FixedVec2 {x - other.x, y - other.y};
+    }
+
+    constexpr FixedVec2 operator*(Fixed scale) const
+    {
+        return FixedVec2 {x * scale, y * scale};
+    }
+
+    FixedVec2& operator+=(FixedVec2 other)
+    {
+        x += other.x;
+        y += other.y;
+        return *this;
+    }
+};
+
+/* Largest r with r * r <= value, bit by bit */
+inline uint64_t isqrt(uint64_t value)
+{
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit)
+    {
+        if (value >= result + bit)
+        {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+inline Fixed abs(Fixed value)
+{
+    return Fixed {value.raw < 0 ? -value.raw : value.raw};
+}
+
+/* Length from the exact Q32.32 sum of squares */
+inline Fixed length(FixedVec2 v)
+{
+    auto x = static_cast<int64_t>(v.x.raw);
+    auto y = static_cast<int64_t>(v.y.raw);
+    return Fixed {static_cast<int32_t>(isqrt(static_cast<uint64_t>((x * x) + (y * y))))};
+}
+
+/* v scaled to the given length, v must not be zero */
+inline FixedVec2 normalize(FixedVec2 v, Fixed to = Fixed {Fixed::ONE})
+{
+    auto len = static_cast<int64_t>(length(v).raw);
+    return FixedVec2 {Fixed {static_cast<int32_t>((static_cast<int64_t>(v.x.raw) * to.raw) / len)},
+                      Fixed {static_cast<int32_t>((static_cast<int64_t>(v.y.raw) * to.raw) / len)}};
+}
@@ -0,0 +1,257 @@
+#include "fixedworld.hpp"
+
+#include "rules.hpp"
+
+/* Constants are converted once, at compile time */
+static constexpr auto BALL_V = Fixed::fromFloat(BALL_SPEED);
+static constexpr auto PADDLE_V = Fixed::fromFloat(PADDLE_SPEED);
+static constexpr auto MIN_SERVE_X = Fixed::fromFloat(0.01f);
+static constexpr auto PADDLE_X = Fixed::fromFloat((GAME_WIDTH / 2.0f) - PADDLE_INSET);
+
+static constexpr FixedVec2 BALL_HALF {Fixed::fromFloat(BALL_SIZE / 2.0f), Fixed::fromFloat(BALL_SIZE / 2.0f)};
+static constexpr FixedVec2 PADDLE_HALF {Fixed::fromFloat(PADDLE_WIDTH / 2.0f), Fixed::fromFloat(PADDLE_HEIGHT / 2.0f)};
+
+struct Box
+{
+    FixedVec2 pos;
+    FixedVec2 half;
+};
+
+/* Same layout as World::init() */
+static constexpr Box BOUNCE_WALLS[] = {
+    {{Fixed::fromInt(0), Fixed::fromFloat((-GAME_HEIGHT / 2.0f) - (WALL_THICKNESS / 2.0f))},
+     {Fixed::fromFloat(GAME_WIDTH / 2.0f), Fixed::fromFloat(WALL_THICKNESS / 2.0f)}},
+    {{Fixed::fromInt(0), Fixed::fromFloat((GAME_HEIGHT / 2.0f) + (WALL_THICKNESS / 2.0f))},
+     {Fixed::fromFloat(GAME_WIDTH / 2.0f), Fixed::fromFloat(WALL_THICKNESS / 2.0f)}},
+};
+
+/* Indexed by the player credited when the ball reaches them */
+static constexpr Box SCORE_WALLS[] = {
+    {{Fixed::fromFloat((GAME_WIDTH / 2.0f) + (WALL_THICKNESS / 2.0f)), Fixed::fromInt(0)},
+     {Fixed::fromFloat(WALL_THICKNESS / 2.0f), Fixed::fromFloat((GAME_HEIGHT / 2.0f) + WALL_THICKNESS)}},
+    {{Fixed::fromFloat((-GAME_WIDTH / 2.0f) - (WALL_THICKNESS / 2.0f)), Fixed::fromInt(0)},
+     {Fixed::fromFloat(WALL_THICKNESS / 2.0f), Fixed::fromFloat((GAME_HEIGHT / 2.0f) + WALL_THICKNESS)}},
+};
+
+/*
+ * Push moving a out of b along the axis of least overlap, zero when they do
+ * not overlap. Ties go to the x axis.
+ */
+static FixedVec2 penetration(const Box& a, const Box& b)
+{
+    auto d = a.pos - b.pos;
+    auto overlap = (a.half + b.half) - FixedVec2 {abs(d.x), abs(d.y)};
+    if (overlap.x <= Fixed {0} || overlap.y <= Fixed {0})
+    {
+        return {};
+    }
+    if (overlap.x <= overlap.y)
+    {
+        return {d.x < Fixed {0} ? -overlap.x : overlap.x, Fixed {0}};
+    }
+    return {Fixed {0}, d.y < Fixed {0} ? -overlap.y : overlap.y};
+}
+
+/* Larger magnitude wins, ties go to the larger value, like Resolution */
+static Fixed largest(Fixed a, Fixed b)
+{
+    auto aa = abs(a);
+    auto ab = abs(b);
+    return (aa > ab || (aa == ab && a > b)) ? a : b;
+}
+
+FixedWorld::FixedWorld()
+    : _state {},
+      _players(1),
+      _dt(Fixed::fromFloat(World::dT))
+{
+    init(0);
+}
+
+void FixedWorld::init(uint64_t seed, int players)
+{
+    _players = players;
+    _state.rng.seed(seed);
+    _state.paddlePos[0] = {-PADDLE_X, Fixed {0}};
+    _state.paddlePos[1] = {PADDLE_X, Fixed {0}};
+    _state.paddleV[0] = {};
+    _state.paddleV[1] = {};
+    _state.scores[0] = 0;
+    _state.scores[1] = 0;
+    reset();
+}
+
+void FixedWorld::reset()
+{
+    _state.ballPos = {};
+    _state.ballV = {};
+    _state.idle = true;
+}
+
+FixedVec2 FixedWorld::ballPos() const
+{
+    return _state.ballPos;
+}
+
+FixedVec2 FixedWorld::ballV() const
+{
+    return _state.ballV;
+}
+
+FixedVec2 FixedWorld::paddlePos(int side) const
+{
+    return _state.paddlePos[side];
+}
+
+FixedVec2 FixedWorld::paddleV(int side) const
+{
+    return _state.paddleV[side];
+}
+
+const int* FixedWorld::scores() const
+{
+    return _state.scores;
+}
+
+bool FixedWorld::idle() const
+{
+    return _state.idle;
+}
+
+const FixedWorld::State& FixedWorld::state() const
+{
+    return _state;
+}
+
+void FixedWorld::setState(const State& state)
+{
+    _state = state;
+}
+
+/* The step is rounded from an exact ratio, so every platform gets the same one */
+void FixedWorld::setTickRate(int hz)
+{
+    _dt = Fixed::fromRaw((Fixed::ONE + (hz / 2)) / hz);
+}
+
+uint8_t FixedWorld::tick(const Keystate& input)
+{
+    return tick(input, Keystate {});
+}
+
+uint8_t FixedWorld::tick(const Keystate& left, const Keystate& right)
+{
+    uint8_t events = 0;
+    control(left, right, events);
+
+    _state.ballPos += _state.ballV * _dt;
+    for (int side = 0; side < 2; side++)
+    {
+        _state.paddlePos[side] += _state.paddleV[side] * _dt;
+
+        /* Paddles are pushed back by the bounce walls */
+        FixedVec2 push {};
+        for (const auto& wall : BOUNCE_WALLS)
+        {
+            auto pv = penetration({_state.paddlePos[side], PADDLE_HALF}, wall);
+            push = {largest(push.x, pv.x), largest(push.y, pv.y)};
+        }
+        _state.paddlePos[side] += push;
+    }
+
+    Box ball {_state.ballPos, BALL_HALF};
+    for (int player = 0; player < 2; player++)
+    {
+        auto pv = penetration(ball, SCORE_WALLS[player]);
+        if (pv.x != Fixed {0} || pv.y != Fixed {0})
+        {
+            _state.scores[player]++;
+            reset();
+            return events | World::SCORED;
+        }
+    }
+
+    /* Accumulate every contact of the ball first, so that their order does not matter */
+    FixedVec2 push {};
+    bool reflectX = false;
+    bool reflectY = false;
+    auto bounce = [&](const Box& other)
+    {
+        auto pv = penetration(ball, other);
+        push = {largest(push.x, pv.x), largest(push.y, pv.y)};
+        reflectX = reflectX || pv.x != Fixed {0};
+        reflectY = reflectY || pv.y != Fixed {0};
+        return pv.x != Fixed {0} || pv.y != Fixed {0};
+    };
+    for (const auto& wall : BOUNCE_WALLS)
+    {
+        bounce(wall);
+    }
+    for (int side = 0; side < 2; side++)
+    {
+        if (bounce({_state.paddlePos[side], PADDLE_HALF}))
+        {
+            events |= World::PADDLE_BOUNCED;
+        }
+    }
+
+    _state.ballPos += push;
+    _state.ballV.x = reflectX ? -_state.ballV.x : _state.ballV.x;
+    _state.ballV.y = reflectY ? -_state.ballV.y : _state.ballV.y;
+    return events;
+}
+
+/* Same policies as World::control() */
+void FixedWorld::control(const Keystate& left, const Keystate& right, uint8_t& events)
+{
+    if ((left.space || right.space) && _state.idle)
+    {
+        /* 17 random bits make a component in [-1, 1) */
+        do
+        {
+            _state.ballV.x = Fixed {static_cast<int32_t>(_state.rng.next() >> 47) - Fixed::ONE};
+            _state.ballV.y = Fixed {static_cast<int32_t>(_state.rng.next() >> 47) - Fixed::ONE};
+        } while (_state.ballV.x < MIN_SERVE_X);
+        events |= World::SERVED;
+        _state.idle = false;
+    }
+    if (_state.ballV.x != Fixed {0} || _state.ballV.y != Fixed {0})
+    {
+        _state.ballV = normalize(_state.ballV, BALL_V);
+    }
+
+    const Keystate* inputs[] = {&left, &right};
+    for (int side = 0; side < _players; side++)
+    {
+        if (inputs[side]->up)
+        {
+            _state.paddleV[side].y = -PADDLE_V;
+        }
+        else if (inputs[side]->down)
+        {
+            _state.paddleV[side].y = PADDLE_V;
+        }
+        else
+        {
+            _state.paddleV[side].y = Fixed {0};
+        }
+    }
+    if (_players == 2)
+    {
+        return;
+    }
+
+    /* Behavior::CPU: chase an incoming ball, back away from an outgoing one. A Bot aims in float, which would not be exact. */
+    auto& v = _state.paddleV[1];
+    auto dy = _state.ballPos.y - _state.paddlePos[1].y;
+    if (_state.ballV.x == Fixed {0} || dy == Fixed {0})
+    {
+        v.y = Fixed {0};
+    }
+    else
+    {
+        bool incoming = _state.ballV.x > Fixed {0};
+        bool below = dy > Fixed {0};
+        v.y = incoming == below ? PADDLE_V : -PADDLE_V;
+    }
+}
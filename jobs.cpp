@@ -0,0 +1,111 @@
+#include "jobs.hpp"
+
+#include <algorithm>
+
+JobPool::JobPool(size_t threads)
+    : _queues(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+      _queued(0),
+      _pending(0),
+      _next(0),
+      _stop(false)
+{
+    _threads.reserve(_queues.size());
+    for (size_t i = 0; i < _queues.size(); i++)
+    {
+        _threads.emplace_back(&JobPool::run, this, i);
+    }
+}
+
+JobPool::~JobPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+void JobPool::submit(Job job)
+{
+    auto& queue = _queues[_next];
+    _next = (_next + 1) % _queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    {
+        /* Counted under _mutex so that a worker about to sleep sees it */
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queued++;
+        _pending++;
+    }
+    _wake.notify_one();
+}
+
+void JobPool::wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this]() { return _pending == 0; });
+}
+
+size_t JobPool::threads() const
+{
+    return _threads.size();
+}
+
+void JobPool::run(size_t worker)
+{
+    Job job;
+    for (;;)
+    {
+        if (pop(worker, job))
+        {
+            job(worker);
+            job = nullptr;
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_pending == 0)
+            {
+                _done.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wake.wait(lock, [this]() { return _stop || _queued > 0; });
+        if (_stop && _queued == 0)
+        {
+            return;
+        }
+    }
+}
+
+/* Newest job of the own queue, else oldest job of the next non-empty one */
+bool JobPool::pop(size_t worker, Job& job)
+{
+    for (size_t i = 0; i < _queues.size(); i++)
+    {
+        auto& queue = _queues[(worker + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+        {
+            continue;
+        }
+        if (i == 0)
+        {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+        }
+        else
+        {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+        _queued--;
+        return true;
+    }
+    return false;
+}
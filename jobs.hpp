@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stddef.h>
+#include <thread>
+#include <vector>
+
+/*
+ * Work-stealing thread pool.
+ *
+ * Every worker owns a queue. Jobs are dealt round-robin to the queues, a
+ * worker takes the newest job of its own queue and, when it runs dry, steals
+ * the oldest job of another one, so that uneven jobs still keep every core
+ * busy. Each queue sits on its own cache line.
+ *
+ * A job receives the index of the worker running it, to write into per-worker
+ * state without locking. Jobs run on the workers only: wait() blocks until
+ * every submitted job is done. submit() and wait() belong to the thread owning
+ * the pool.
+ */
+class JobPool
+{
+public:
+    using Job = std::function<void(size_t worker)>;
+
+    explicit JobPool(size_t threads = 0); /* 0 for one per hardware thread */
+    ~JobPool();
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    void submit(Job job);
+    void wait();
+    size_t threads() const;
+
+private:
+    struct alignas(64) Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<Queue> _queues;
+    std::vector<std::thread> _threads;
+    std::atomic<size_t> _queued; /* jobs waiting in a queue */
+    std::mutex _mutex;           /* guards _pending and _stop, and the sleeps */
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    size_t _pending; /* jobs submitted and not finished yet */
+    size_t _next;    /* queue receiving the next job */
+    bool _stop;
+
+    void run(size_t worker);
+    bool pop(size_t worker, Job& job);
+};
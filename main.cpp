@@ -9,7 +9,17 @@ extern "C" const char* __asan_default_options() { return "detect_leaks=0"; }
 
 SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[])
 {
-    if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO))
+    /* Headless runs need neither a display nor an audio device */
+    SDL_InitFlags flags = SDL_INIT_VIDEO | SDL_INIT_AUDIO;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--headless"))
+        {
+            flags = 0;
+        }
+    }
+
+    if (!SDL_Init(flags))
     {
         fmt::println(stderr, "Couldn't initialize SDL: {}", SDL_GetError());
         return SDL_APP_FAILURE;
@@ -0,0 +1,110 @@
+#include "matchfarm.hpp"
+
+#include <algorithm>
+#include <vector>
+
+/* Per worker and per setup, kept apart so that workers never share a line */
+struct alignas(64) Accumulator
+{
+    FarmResult result;
+};
+
+static void playBatch(const FarmSetup& setup, const Rng& stream, size_t matches, FarmResult& result)
+{
+    BatchSim sim(matches, stream, setup.left, setup.right, setup.ballSpeed, setup.paddleSpeed);
+    for (int side = 0; side < 2; side++)
+    {
+        if (setup.skills[side])
+        {
+            sim.setSkill(side, *setup.skills[side]);
+        }
+        if (setup.policies[side])
+        {
+            sim.setPolicy(side, *setup.policies[side]);
+        }
+        sim.setTable(side, setup.tables[side]);
+    }
+    for (size_t t = 0; t < setup.ticks; t++)
+    {
+        sim.tick();
+
+        size_t count;
+        auto scored = sim.scored(&count);
+        for (size_t i = 0; i < count; i++)
+        {
+            if (scored[i] < matches)
+            {
+                auto bin = sim.rallyTicks(scored[i]) / FarmResult::RALLY_BIN_TICKS;
+                result.rallies[std::min<size_t>(bin, FarmResult::RALLY_BINS - 1)]++;
+            }
+        }
+    }
+
+    /* The BatchSim may round its lanes up, the extra ones are not counted */
+    for (size_t i = 0; i < matches; i++)
+    {
+        int32_t left = sim.scores(0)[i];
+        int32_t right = sim.scores(1)[i];
+        result.wins[0] += left > right;
+        result.wins[1] += right > left;
+        result.draws += left == right;
+        result.points[0] += left;
+        result.points[1] += right;
+    }
+    result.matches += matches;
+    result.ticks += matches * setup.ticks;
+}
+
+MatchFarm::MatchFarm(JobPool& pool)
+    : _pool(pool)
+{
+}
+
+FarmResult MatchFarm::play(const FarmSetup& setup)
+{
+    FarmResult result;
+    sweep(&setup, 1, &result);
+    return result;
+}
+
+void MatchFarm::sweep(const FarmSetup* setups, size_t count, FarmResult* results)
+{
+    auto workers = _pool.threads();
+    std::vector<Accumulator> accumulators(workers * count);
+
+    for (size_t s = 0; s < count; s++)
+    {
+        const auto& setup = setups[s];
+        Rng stream(setup.seed);
+        for (size_t first = 0; first < setup.matches; first += BATCH_LANES)
+        {
+            auto matches = std::min(BATCH_LANES, setup.matches - first);
+            _pool.submit([&setup, &accumulators, stream, matches, count, s](size_t worker)
+                         { playBatch(setup, stream, matches, accumulators[(worker * count) + s].result); });
+            stream.longJump();
+        }
+    }
+    _pool.wait();
+
+    for (size_t s = 0; s < count; s++)
+    {
+        auto& result = results[s];
+        result = {};
+        for (size_t w = 0; w < workers; w++)
+        {
+            const auto& partial = accumulators[(w * count) + s].result;
+            result.matches += partial.matches;
+            result.draws += partial.draws;
+            result.ticks += partial.ticks;
+            for (int side = 0; side < 2; side++)
+            {
+                result.wins[side] += partial.wins[side];
+                result.points[side] += partial.points[side];
+            }
+            for (size_t bin = 0; bin < FarmResult::RALLY_BINS; bin++)
+            {
+                result.rallies[bin] += partial.rallies[bin];
+            }
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "batchsim.hpp"
+#include "jobs.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+/* One set of rules to play many matches with */
+struct FarmSetup
+{
+    BatchSim::Controller left;
+    BatchSim::Controller right;
+    float ballSpeed;
+    float paddleSpeed;
+    size_t matches;
+    size_t ticks; /* length of a match */
+    uint64_t seed;
+    const BotSkill* skills[2] = {nullptr, nullptr};    /* of BOT sides, normal when null */
+    const MlpPolicy* policies[2] = {nullptr, nullptr}; /* of MLP sides, still when null */
+    const PolicyTable* tables[2] = {nullptr, nullptr};  /* of TABLE sides, still when null */
+};
+
+struct FarmResult
+{
+    static constexpr size_t RALLY_BINS = 32;
+    static constexpr size_t RALLY_BIN_TICKS = 30; /* the last bin holds every longer rally */
+
+    uint64_t matches;
+    uint64_t wins[2]; /* matches ended with more points for a side */
+    uint64_t draws;
+    uint64_t points[2];
+    uint64_t ticks; /* match ticks simulated, all matches together */
+    uint64_t rallies[RALLY_BINS]; /* points by ticks between the serve and the point */
+};
+
+/*
+ * Plays matches of fixed length on a JobPool, in BatchSim batches of
+ * BATCH_LANES matches, and sums up who won.
+ *
+ * The results only depend on the setups: batch b of a setup draws from the
+ * setup seed after b long jumps, whichever worker runs it, and every worker
+ * adds into its own cache line sized accumulator which are summed in worker
+ * order at the end. All setups of a sweep are queued at once so that the
+ * pool stays busy across them.
+ */
+class MatchFarm
+{
+public:
+    static constexpr size_t BATCH_LANES = 1024;
+
+    explicit MatchFarm(JobPool& pool);
+    FarmResult play(const FarmSetup& setup);
+    void sweep(const FarmSetup* setups, size_t count, FarmResult* results);
+
+private:
+    JobPool& _pool;
+};
@@ -0,0 +1,198 @@
+#include "mlp.hpp"
+
+#include "rules.hpp"
+#include "simd.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static constexpr auto LANE_WIDTH = 8;
+static constexpr uint8_t MAGIC[7] = {'P', 'O', 'N', 'G', 'M', 'L', 'P'};
+static constexpr uint8_t VERSION = 1;
+
+/* Scales of the inputs, x ones are also multiplied by the side */
+static constexpr float SCALE_X = 2.0f / GAME_WIDTH;
+static constexpr float SCALE_Y = 2.0f / GAME_HEIGHT;
+static constexpr float SCALE_V = 1.0f / BALL_SPEED;
+
+/* Offsets of the layers in the parameters */
+static constexpr size_t HIDDEN_BIAS = MlpPolicy::HIDDEN * MlpPolicy::INPUTS;
+static constexpr size_t OUTPUT_WEIGHTS = HIDDEN_BIAS + MlpPolicy::HIDDEN;
+static constexpr size_t OUTPUT_BIAS = OUTPUT_WEIGHTS + MlpPolicy::HIDDEN;
+
+/*
+ * Both kernels evaluate the same operations in the same order, without
+ * fused multiply-adds, so that they agree to the bit. The selects mirror
+ * those of _mm256_max_ps and _mm256_min_ps.
+ */
+static float actScalar(const float* p, const float* in)
+{
+    float out = p[OUTPUT_BIAS];
+    for (size_t h = 0; h < MlpPolicy::HIDDEN; h++)
+    {
+        float acc = p[HIDDEN_BIAS + h];
+        for (size_t i = 0; i < MlpPolicy::INPUTS; i++)
+        {
+            acc = acc + (p[(h * MlpPolicy::INPUTS) + i] * in[i]);
+        }
+        acc = acc > 0.0f ? acc : 0.0f;
+        out = out + (p[OUTPUT_WEIGHTS + h] * acc);
+    }
+    out = out > -1.0f ? out : -1.0f;
+    return out < 1.0f ? out : 1.0f;
+}
+
+static void runScalar(const MlpPolicy& policy, const MlpInputs& inputs, size_t count, float* actions)
+{
+    float scaleX = inputs.side * SCALE_X;
+    float scaleVX = inputs.side * SCALE_V;
+    for (size_t lane = 0; lane < count; lane++)
+    {
+        float in[MlpPolicy::INPUTS] = {inputs.ballX[lane] * scaleX,
+                                       inputs.ballY[lane] * SCALE_Y,
+                                       inputs.ballVX[lane] * scaleVX,
+                                       inputs.ballVY[lane] * SCALE_V,
+                                       inputs.paddleY[lane] * SCALE_Y};
+        actions[lane] = actScalar(policy.parameters(), in);
+    }
+}
+
+#ifdef SIMD_X86
+/* 8 lanes at a time, the weights broadcast from the parameters */
+TARGET_AVX2 static void runAvx2(const MlpPolicy& policy, const MlpInputs& inputs, size_t count, float* actions)
+{
+    const float* p = policy.parameters();
+    const auto zero = _mm256_setzero_ps();
+    const auto scaleX = _mm256_set1_ps(inputs.side * SCALE_X);
+    const auto scaleY = _mm256_set1_ps(SCALE_Y);
+    const auto scaleVX = _mm256_set1_ps(inputs.side * SCALE_V);
+    const auto scaleV = _mm256_set1_ps(SCALE_V);
+
+    for (size_t lane = 0; lane < count; lane += LANE_WIDTH)
+    {
+        __m256 in[MlpPolicy::INPUTS] = {_mm256_mul_ps(_mm256_loadu_ps(inputs.ballX + lane), scaleX),
+                                        _mm256_mul_ps(_mm256_loadu_ps(inputs.ballY + lane), scaleY),
+                                        _mm256_mul_ps(_mm256_loadu_ps(inputs.ballVX + lane), scaleVX),
+                                        _mm256_mul_ps(_mm256_loadu_ps(inputs.ballVY + lane), scaleV),
+                                        _mm256_mul_ps(_mm256_loadu_ps(inputs.paddleY + lane), scaleY)};
+        auto out = _mm256_set1_ps(p[OUTPUT_BIAS]);
+        for (size_t h = 0; h < MlpPolicy::HIDDEN; h++)
+        {
+            auto acc = _mm256_set1_ps(p[HIDDEN_BIAS + h]);
+            for (size_t i = 0; i < MlpPolicy::INPUTS; i++)
+            {
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(p[(h * MlpPolicy::INPUTS) + i]), in[i]));
+            }
+            acc = _mm256_max_ps(acc, zero);
+            out = _mm256_add_ps(out, _mm256_mul_ps(_mm256_set1_ps(p[OUTPUT_WEIGHTS + h]), acc));
+        }
+        out = _mm256_min_ps(_mm256_max_ps(out, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+        _mm256_storeu_ps(actions + lane, out);
+    }
+}
+#endif
+
+struct MlpKernelTable
+{
+    MlpKernel kernels[2];
+    size_t count;
+};
+
+static MlpKernelTable detectMlpKernels()
+{
+    MlpKernelTable table {};
+    table.kernels[table.count++] = {"scalar", runScalar};
+#ifdef SIMD_X86
+    if (cpuHasAvx2())
+    {
+        table.kernels[table.count++] = {"avx2", runAvx2};
+    }
+#endif
+    return table;
+}
+
+const MlpKernel* mlpKernels(size_t* count)
+{
+    static const MlpKernelTable table = detectMlpKernels();
+    *count = table.count;
+    return table.kernels;
+}
+
+/*** MlpPolicy **********************************************************************/
+MlpPolicy::MlpPolicy()
+    : _parameters {}
+{
+}
+
+/* One paddle, the same arithmetic as the kernels */
+float MlpPolicy::act(glm::vec2 ball, glm::vec2 ballV, float paddleY, float side) const
+{
+    float in[INPUTS] = {ball.x * (side * SCALE_X), ball.y * SCALE_Y, ballV.x * (side * SCALE_V), ballV.y * SCALE_V, paddleY * SCALE_Y};
+    return actScalar(_parameters, in);
+}
+
+float* MlpPolicy::parameters()
+{
+    return _parameters;
+}
+
+const float* MlpPolicy::parameters() const
+{
+    return _parameters;
+}
+
+bool MlpPolicy::save(const char* path) const
+{
+    std::vector<uint8_t> data(MAGIC, MAGIC + sizeof(MAGIC));
+    data.push_back(VERSION);
+    data.push_back(static_cast<uint8_t>(INPUTS));
+    data.push_back(static_cast<uint8_t>(HIDDEN));
+    for (auto parameter : _parameters)
+    {
+        uint32_t bits;
+        memcpy(&bits, &parameter, sizeof(bits));
+        for (int i = 0; i < 4; i++)
+        {
+            data.push_back(static_cast<uint8_t>(bits >> (i * 8)));
+        }
+    }
+
+    auto file = fopen(path, "wb");
+    if (!file)
+    {
+        return false;
+    }
+    bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return (fclose(file) == 0) && written;
+}
+
+/* False if the file cannot be read or holds another network, the policy is then unchanged */
+bool MlpPolicy::load(const char* path)
+{
+    static constexpr size_t SIZE = sizeof(MAGIC) + 3 + (PARAMETERS * 4);
+    auto file = fopen(path, "rb");
+    if (!file)
+    {
+        return false;
+    }
+    uint8_t data[SIZE + 1];
+    auto size = fread(data, 1, sizeof(data), file);
+    fclose(file);
+    if (size != SIZE || memcmp(data, MAGIC, sizeof(MAGIC)))
+    {
+        return false;
+    }
+    auto header = data + sizeof(MAGIC);
+    if (header[0] != VERSION || header[1] != INPUTS || header[2] != HIDDEN)
+    {
+        return false;
+    }
+
+    auto bytes = header + 3;
+    for (size_t k = 0; k < PARAMETERS; k++, bytes += 4)
+    {
+        uint32_t bits = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+        memcpy(&_parameters[k], &bits, sizeof(bits));
+    }
+    return true;
+}
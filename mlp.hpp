@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+class MlpPolicy;
+
+/* What the paddles of count lanes see, one value per lane, as a BatchSim stores it */
+struct MlpInputs
+{
+    const float* ballX;
+    const float* ballY;
+    const float* ballVX;
+    const float* ballVY;
+    const float* paddleY;
+    float side; /* 1 for the right paddle, -1 for the left one */
+};
+
+/* Writes the action of count lanes (a multiple of 8) to actions */
+using MlpKernelFn = void (*)(const MlpPolicy& policy, const MlpInputs& inputs, size_t count, float* actions);
+
+struct MlpKernel
+{
+    const char* name;
+    MlpKernelFn run;
+};
+
+/* Kernels usable on this CPU, fastest last. The scalar kernel is always first. */
+const MlpKernel* mlpKernels(size_t* count);
+
+/*
+ * Learned paddle policy: a perceptron with one hidden layer of ReLU units,
+ * from what a paddle sees to how it moves.
+ *
+ * The inputs are the ball position and velocity and the paddle position,
+ * scaled to about [-1, 1]. The left paddle sees the field mirrored, so one
+ * policy plays either side. The action is the paddle velocity as a fraction
+ * of PADDLE_SPEED, clamped to [-1, 1].
+ *
+ * The parameters are, in order: the hidden weights unit by unit
+ * [HIDDEN][INPUTS], the hidden biases [HIDDEN], the output weights [HIDDEN]
+ * and the output bias. Files hold a magic, a version, INPUTS and HIDDEN as a
+ * byte each, then the parameters as little endian floats.
+ */
+class MlpPolicy
+{
+public:
+    static constexpr size_t INPUTS = 5;
+    static constexpr size_t HIDDEN = 16;
+    static constexpr size_t PARAMETERS = (HIDDEN * INPUTS) + HIDDEN + HIDDEN + 1;
+
+    MlpPolicy(); /* every parameter 0, the paddle stays still */
+    float act(glm::vec2 ball, glm::vec2 ballV, float paddleY, float side) const;
+    float* parameters();
+    const float* parameters() const;
+    bool save(const char* path) const;
+    bool load(const char* path);
+
+private:
+    float _parameters[PARAMETERS];
+};
@@ -0,0 +1,207 @@
+#include "narrowphase.hpp"
+
+#include "simd.hpp"
+#include <string.h>
+
+/*
+ * All kernels compute the half extents as size * 0.5f so that they agree to
+ * the bit with each other.
+ */
+static size_t narrowphaseScalar(const BodyPair* pairs, size_t count, const glm::vec2* pos, const glm::vec2* size, Contact* contacts)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        auto a = pairs[i].a;
+        auto b = pairs[i].b;
+        glm::vec2 d = pos[b] - pos[a];
+        float px = (size[a].x * 0.5f + size[b].x * 0.5f) - std::abs(d.x);
+        float py = (size[a].y * 0.5f + size[b].y * 0.5f) - std::abs(d.y);
+        if (px <= 0.0f || py <= 0.0f)
+        {
+            continue;
+        }
+
+        auto& contact = contacts[n++];
+        contact.a = a;
+        contact.b = b;
+        if (px < py)
+        {
+            contact.pv = {d.x < 0.0f ? -px : px, 0.0f};
+        }
+        else
+        {
+            contact.pv = {0.0f, d.y < 0.0f ? -py : py};
+        }
+    }
+    return n;
+}
+
+#ifdef SIMD_X86
+/* Appends the lanes set in mask as contacts */
+static size_t emitContacts(const BodyPair* pairs, unsigned mask, const float* pvx, const float* pvy, Contact* contacts)
+{
+    size_t n = 0;
+    while (mask)
+    {
+        auto lane = lowestBit(mask);
+        auto& contact = contacts[n++];
+        contact.a = pairs[lane].a;
+        contact.b = pairs[lane].b;
+        contact.pv = {pvx[lane], pvy[lane]};
+        mask &= mask - 1;
+    }
+    return n;
+}
+
+static size_t narrowphaseSse2(const BodyPair* pairs, size_t count, const glm::vec2* pos, const glm::vec2* size, Contact* contacts)
+{
+    const auto half = _mm_set1_ps(0.5f);
+    const auto zero = _mm_setzero_ps();
+    const auto signBit = _mm_set1_ps(-0.0f);
+
+    size_t n = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const auto* p = pairs + i;
+        auto ax = _mm_setr_ps(pos[p[0].a].x, pos[p[1].a].x, pos[p[2].a].x, pos[p[3].a].x);
+        auto ay = _mm_setr_ps(pos[p[0].a].y, pos[p[1].a].y, pos[p[2].a].y, pos[p[3].a].y);
+        auto bx = _mm_setr_ps(pos[p[0].b].x, pos[p[1].b].x, pos[p[2].b].x, pos[p[3].b].x);
+        auto by = _mm_setr_ps(pos[p[0].b].y, pos[p[1].b].y, pos[p[2].b].y, pos[p[3].b].y);
+        auto asx = _mm_setr_ps(size[p[0].a].x, size[p[1].a].x, size[p[2].a].x, size[p[3].a].x);
+        auto asy = _mm_setr_ps(size[p[0].a].y, size[p[1].a].y, size[p[2].a].y, size[p[3].a].y);
+        auto bsx = _mm_setr_ps(size[p[0].b].x, size[p[1].b].x, size[p[2].b].x, size[p[3].b].x);
+        auto bsy = _mm_setr_ps(size[p[0].b].y, size[p[1].b].y, size[p[2].b].y, size[p[3].b].y);
+
+        auto dx = _mm_sub_ps(bx, ax);
+        auto dy = _mm_sub_ps(by, ay);
+        auto px = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(asx, half), _mm_mul_ps(bsx, half)), _mm_andnot_ps(signBit, dx));
+        auto py = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(asy, half), _mm_mul_ps(bsy, half)), _mm_andnot_ps(signBit, dy));
+
+        auto hit = _mm_and_ps(_mm_cmpgt_ps(px, zero), _mm_cmpgt_ps(py, zero));
+        auto mask = static_cast<unsigned>(_mm_movemask_ps(hit));
+        if (!mask)
+        {
+            continue;
+        }
+
+        /* pv = px < py ? (±px, 0) : (0, ±py), with the sign of d */
+        auto alongX = _mm_cmplt_ps(px, py);
+        auto sx = _mm_xor_ps(px, _mm_and_ps(_mm_cmplt_ps(dx, zero), signBit));
+        auto sy = _mm_xor_ps(py, _mm_and_ps(_mm_cmplt_ps(dy, zero), signBit));
+        alignas(16) float pvx[4];
+        alignas(16) float pvy[4];
+        _mm_store_ps(pvx, _mm_and_ps(alongX, sx));
+        _mm_store_ps(pvy, _mm_andnot_ps(alongX, sy));
+        n += emitContacts(p, mask, pvx, pvy, contacts + n);
+    }
+    return n + narrowphaseScalar(pairs + i, count - i, pos, size, contacts + n);
+}
+
+TARGET_AVX2 static size_t narrowphaseAvx2(const BodyPair* pairs, size_t count, const glm::vec2* pos, const glm::vec2* size, Contact* contacts)
+{
+    static_assert(sizeof(glm::vec2) == 2 * sizeof(float), "glm::vec2 must be two packed floats");
+    static_assert(sizeof(BodyPair) == 2 * sizeof(uint32_t), "BodyPair must be two packed indices");
+
+    const auto half = _mm256_set1_ps(0.5f);
+    const auto zero = _mm256_setzero_ps();
+    const auto signBit = _mm256_set1_ps(-0.0f);
+    const auto evens = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const auto* posData = reinterpret_cast<const float*>(pos);
+    const auto* sizeData = reinterpret_cast<const float*>(size);
+
+    size_t n = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto* p = pairs + i;
+
+        /* De-interleave the (a, b) indices and turn them into float offsets */
+        auto lo = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), evens);
+        auto hi = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 4)), evens);
+        auto ia = _mm256_slli_epi32(_mm256_permute2x128_si256(lo, hi, 0x20), 1);
+        auto ib = _mm256_slli_epi32(_mm256_permute2x128_si256(lo, hi, 0x31), 1);
+        auto one = _mm256_set1_epi32(1);
+
+        auto ax = _mm256_i32gather_ps(posData, ia, 4);
+        auto ay = _mm256_i32gather_ps(posData, _mm256_add_epi32(ia, one), 4);
+        auto bx = _mm256_i32gather_ps(posData, ib, 4);
+        auto by = _mm256_i32gather_ps(posData, _mm256_add_epi32(ib, one), 4);
+        auto asx = _mm256_i32gather_ps(sizeData, ia, 4);
+        auto asy = _mm256_i32gather_ps(sizeData, _mm256_add_epi32(ia, one), 4);
+        auto bsx = _mm256_i32gather_ps(sizeData, ib, 4);
+        auto bsy = _mm256_i32gather_ps(sizeData, _mm256_add_epi32(ib, one), 4);
+
+        auto dx = _mm256_sub_ps(bx, ax);
+        auto dy = _mm256_sub_ps(by, ay);
+        auto px = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(asx, half), _mm256_mul_ps(bsx, half)), _mm256_andnot_ps(signBit, dx));
+        auto py = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(asy, half), _mm256_mul_ps(bsy, half)), _mm256_andnot_ps(signBit, dy));
+
+        auto hit = _mm256_and_ps(_mm256_cmp_ps(px, zero, _CMP_GT_OQ), _mm256_cmp_ps(py, zero, _CMP_GT_OQ));
+        auto mask = static_cast<unsigned>(_mm256_movemask_ps(hit));
+        if (!mask)
+        {
+            continue;
+        }
+
+        auto alongX = _mm256_cmp_ps(px, py, _CMP_LT_OQ);
+        auto sx = _mm256_xor_ps(px, _mm256_and_ps(_mm256_cmp_ps(dx, zero, _CMP_LT_OQ), signBit));
+        auto sy = _mm256_xor_ps(py, _mm256_and_ps(_mm256_cmp_ps(dy, zero, _CMP_LT_OQ), signBit));
+        alignas(32) float pvx[8];
+        alignas(32) float pvy[8];
+        _mm256_store_ps(pvx, _mm256_and_ps(alongX, sx));
+        _mm256_store_ps(pvy, _mm256_andnot_ps(alongX, sy));
+        n += emitContacts(p, mask, pvx, pvy, contacts + n);
+    }
+    return n + narrowphaseScalar(pairs + i, count - i, pos, size, contacts + n);
+}
+#endif
+
+struct KernelTable
+{
+    Narrowphase kernels[3];
+    size_t count;
+};
+
+static KernelTable detectKernels()
+{
+    KernelTable table {};
+    table.kernels[table.count++] = {"scalar", narrowphaseScalar};
+#ifdef SIMD_X86
+    table.kernels[table.count++] = {"sse2", narrowphaseSse2};
+    if (cpuHasAvx2())
+    {
+        table.kernels[table.count++] = {"avx2", narrowphaseAvx2};
+    }
+#endif
+    return table;
+}
+
+const Narrowphase* narrowphaseKernels(size_t* count)
+{
+    static const KernelTable table = detectKernels();
+    *count = table.count;
+    return table.kernels;
+}
+
+Narrowphase selectNarrowphase()
+{
+    size_t count;
+    auto kernels = narrowphaseKernels(&count);
+    return kernels[count - 1];
+}
+
+const Narrowphase* findNarrowphase(const char* name)
+{
+    size_t count;
+    auto kernels = narrowphaseKernels(&count);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!strcmp(kernels[i].name, name))
+        {
+            return &kernels[i];
+        }
+    }
+    return nullptr;
+}
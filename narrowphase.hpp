@@ -0,0 +1,35 @@
+#pragma once
+
+#include "broadphase.hpp"
+#include <glm/glm.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+struct Contact
+{
+    uint32_t a;
+    uint32_t b;
+    glm::vec2 pv; /* penetration vector, from a towards b */
+};
+
+/*
+ * Exact AABB test of a batch of candidate pairs. Writes one contact per
+ * overlapping pair, in pair order, and returns the number of contacts.
+ * contacts must have room for count entries.
+ */
+using NarrowphaseFn = size_t (*)(const BodyPair* pairs, size_t count, const glm::vec2* pos, const glm::vec2* size, Contact* contacts);
+
+struct Narrowphase
+{
+    const char* name;
+    NarrowphaseFn run;
+};
+
+/* Kernels usable on this CPU, fastest last. The scalar kernel is always first. */
+const Narrowphase* narrowphaseKernels(size_t* count);
+
+/* Fastest kernel usable on this CPU */
+Narrowphase selectNarrowphase();
+
+/* Kernel by name ("scalar", "sse2", "avx2"), or nullptr if unknown or unsupported */
+const Narrowphase* findNarrowphase(const char* name);
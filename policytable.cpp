@@ -0,0 +1,209 @@
+#include "policytable.hpp"
+
+#include "bot.hpp"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#    define POLICYTABLE_MMAP 0
+#else
+#    define POLICYTABLE_MMAP 1
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+static constexpr uint8_t MAGIC[7] = {'P', 'O', 'N', 'G', 'L', 'U', 'T'};
+static constexpr uint8_t VERSION = 2;
+static constexpr size_t FILE_SIZE = PolicyTable::HEADER_SIZE + PolicyTable::BYTES;
+
+/* Ball center on contact with the right paddle, the mirrored frame of the table */
+static constexpr float FACE_X = ((GAME_WIDTH / 2.0f) - PADDLE_INSET) - ((PADDLE_WIDTH + BALL_SIZE) / 2.0f);
+
+/* Samples per cell along the ball position and slope, the solve takes their median target */
+static constexpr int SAMPLES = 4;
+
+static void header(uint8_t* out)
+{
+    memset(out, 0, PolicyTable::HEADER_SIZE);
+    memcpy(out, MAGIC, sizeof(MAGIC));
+    out[7] = VERSION;
+    out[8] = PolicyTable::X_BINS;
+    out[9] = PolicyTable::Y_BINS;
+    out[10] = PolicyTable::SLOPE_BINS;
+    out[11] = PolicyTable::PADDLE_BINS;
+}
+
+/* Value at fraction t of bin i of [-half, half] */
+static float binPoint(size_t i, float t, float half, size_t bins)
+{
+    return -half + ((static_cast<float>(i) + t) * (2.0f * half / bins));
+}
+
+/* Where the paddle should be, as a Bot of perfect skill would plan it */
+static float target(glm::vec2 ball, glm::vec2 v)
+{
+    if (v.x <= 0.0f)
+    {
+        return 0.0f;
+    }
+    return ball.x < FACE_X ? interceptY(ball, v, FACE_X) : ball.y;
+}
+
+PolicyTable::PolicyTable()
+    : _packed(nullptr),
+      _mapping(nullptr),
+      _size(0)
+{
+}
+
+PolicyTable::~PolicyTable()
+{
+    unmap();
+}
+
+/*
+ * Each (ball position, direction) cell moves towards the median target of
+ * its samples, so a paddle cell gets the action most samples agree on, with
+ * a dead band of half a paddle cell around the target.
+ */
+bool PolicyTable::build(const char* path)
+{
+    std::vector<uint8_t> data(FILE_SIZE);
+    header(data.data());
+    auto packed = data.data() + HEADER_SIZE;
+
+    static constexpr float DEAD_BAND = PADDLE_MAX_Y / PADDLE_BINS;
+    float targets[SAMPLES * SAMPLES * SAMPLES];
+    size_t index = 0;
+    for (size_t x = 0; x < X_BINS; x++)
+    {
+        for (size_t y = 0; y < Y_BINS; y++)
+        {
+            for (size_t s = 0; s < 2 * SLOPE_BINS; s++)
+            {
+                float direction = s >= SLOPE_BINS ? 1.0f : -1.0f;
+                int n = 0;
+                for (int i = 0; i < SAMPLES; i++)
+                {
+                    for (int j = 0; j < SAMPLES; j++)
+                    {
+                        for (int k = 0; k < SAMPLES; k++)
+                        {
+                            glm::vec2 ball {binPoint(x, (i + 0.5f) / SAMPLES, GAME_WIDTH / 2.0f, X_BINS),
+                                            binPoint(y, (j + 0.5f) / SAMPLES, GAME_HEIGHT / 2.0f, Y_BINS)};
+                            float slope = binPoint(s % SLOPE_BINS, (k + 0.5f) / SAMPLES, 1.0f, SLOPE_BINS);
+                            targets[n++] = target(ball, {direction * (1.0f - std::abs(slope)), slope});
+                        }
+                    }
+                }
+                std::nth_element(targets, targets + (n / 2), targets + n);
+                float median = targets[n / 2];
+
+                for (size_t p = 0; p < PADDLE_BINS; p++)
+                {
+                    float gap = median - binPoint(p, 0.5f, PADDLE_MAX_Y, PADDLE_BINS);
+                    int action = (gap > DEAD_BAND) - (gap < -DEAD_BAND);
+                    packed[index >> 2] |= static_cast<uint8_t>((action + 1) << ((index & 3) * 2));
+                    index++;
+                }
+            }
+        }
+    }
+
+    auto file = fopen(path, "wb");
+    if (!file)
+    {
+        return false;
+    }
+    bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return (fclose(file) == 0) && written;
+}
+
+/* False if the file can not be read or was built for other bins, the table is then unmapped */
+bool PolicyTable::map(const char* path)
+{
+    unmap();
+    uint8_t expected[HEADER_SIZE];
+    header(expected);
+
+#if POLICYTABLE_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) || static_cast<size_t>(info.st_size) != FILE_SIZE)
+    {
+        close(fd);
+        return false;
+    }
+    auto mapping = mmap(nullptr, FILE_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); /* the mapping keeps the file */
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    _mapping = mapping;
+    _size = FILE_SIZE;
+    auto base = static_cast<const uint8_t*>(mapping);
+#else
+    auto file = fopen(path, "rb");
+    if (!file)
+    {
+        return false;
+    }
+    _buffer.resize(FILE_SIZE + 1);
+    auto read = fread(_buffer.data(), 1, _buffer.size(), file);
+    fclose(file);
+    if (read != FILE_SIZE)
+    {
+        unmap();
+        return false;
+    }
+    auto base = _buffer.data();
+#endif
+
+    if (memcmp(base, expected, HEADER_SIZE))
+    {
+        unmap();
+        return false;
+    }
+    _packed = base + HEADER_SIZE;
+    return true;
+}
+
+void PolicyTable::cells(const float* ballX, const float* ballY, const float* ballVX, const float* ballVY, const float* paddleY, float side, size_t count, uint32_t* out)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = cell({ballX[i], ballY[i]}, {ballVX[i], ballVY[i]}, paddleY[i], side);
+    }
+}
+
+bool PolicyTable::mapped() const
+{
+    return _packed != nullptr;
+}
+
+const uint8_t* PolicyTable::packed() const
+{
+    return _packed;
+}
+
+void PolicyTable::unmap()
+{
+#if POLICYTABLE_MMAP
+    if (_mapping)
+    {
+        munmap(_mapping, _size);
+    }
+#endif
+    _mapping = nullptr;
+    _size = 0;
+    _buffer.clear();
+    _buffer.shrink_to_fit();
+    _packed = nullptr;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "rules.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Paddle policy solved offline into a lookup table: one action (-1, 0 or 1)
+ * per cell of a grid over what a paddle sees.
+ *
+ * The grid spans the ball position, the direction of the ball (towards the
+ * paddle or not, and the share of its speed along y) and the paddle
+ * position. The left paddle sees the field mirrored, as with MlpPolicy. The
+ * ball speed is not part of it: serves and bounces keep it constant.
+ *
+ * A file is a 64 byte header (magic, version, the bin counts) followed by
+ * the actions packed at 2 bits per cell, action + 1, four cells per byte
+ * from the low bits up. The whole table is 32 KiB, so it stays in the L1
+ * cache while lanes look up random cells. map() checks the header against
+ * the compiled bin counts and maps the file read-only and shared, so there
+ * is nothing to parse, the pages are loaded on first use and processes
+ * playing the same table share them through the page cache. A query is a
+ * few multiplies and clamps to compute the cell, then one load and a shift;
+ * batches compute all their cells first, which vectorizes, then load.
+ */
+class PolicyTable
+{
+public:
+    static constexpr uint32_t X_BINS = 16;
+    static constexpr uint32_t Y_BINS = 16;
+    static constexpr uint32_t SLOPE_BINS = 16; /* per direction along x */
+    static constexpr uint32_t PADDLE_BINS = 16;
+    static constexpr size_t CELLS = X_BINS * Y_BINS * (2 * SLOPE_BINS) * PADDLE_BINS;
+    static constexpr size_t BYTES = CELLS / 4; /* of the packed actions */
+    static constexpr size_t HEADER_SIZE = 64;
+
+    PolicyTable();
+    ~PolicyTable();
+    PolicyTable(const PolicyTable&) = delete;
+    PolicyTable& operator=(const PolicyTable&) = delete;
+
+    /* Solves every cell and writes the table to path */
+    static bool build(const char* path);
+
+    bool map(const char* path);
+    bool mapped() const;
+    const uint8_t* packed() const; /* BYTES of them */
+
+    /* Branch-free 32 bit arithmetic, out of range values fall in the edge cells */
+    static uint32_t cell(glm::vec2 ball, glm::vec2 ballV, float paddleY, float side)
+    {
+        float slope = ballV.y / (std::abs(ballV.x) + std::abs(ballV.y) + 1e-9f);
+        uint32_t x = bin(ball.x * side, GAME_WIDTH / 2.0f, X_BINS);
+        uint32_t y = bin(ball.y, GAME_HEIGHT / 2.0f, Y_BINS);
+        uint32_t s = bin(slope, 1.0f, SLOPE_BINS) + (static_cast<uint32_t>(ballV.x * side > 0.0f) * SLOPE_BINS);
+        uint32_t p = bin(paddleY, PADDLE_MAX_Y, PADDLE_BINS);
+        return (((((x * Y_BINS) + y) * (2 * SLOPE_BINS)) + s) * PADDLE_BINS) + p;
+    }
+
+    /* cell() of count lanes stored as structure of arrays, in a loop the compiler vectorizes */
+    static void cells(const float* ballX, const float* ballY, const float* ballVX, const float* ballVY, const float* paddleY, float side, size_t count, uint32_t* out);
+
+    /* Action of a cell in packed actions: -1, 0 or 1 */
+    static int action(const uint8_t* packed, uint32_t cell)
+    {
+        return static_cast<int>((packed[cell >> 2] >> ((cell & 3) * 2)) & 3) - 1;
+    }
+
+    int act(glm::vec2 ball, glm::vec2 ballV, float paddleY, float side) const
+    {
+        return action(_packed, cell(ball, ballV, paddleY, side));
+    }
+
+private:
+    static constexpr float PADDLE_MAX_Y = (GAME_HEIGHT - PADDLE_HEIGHT) / 2.0f;
+
+    const uint8_t* _packed;
+    void* _mapping;
+    size_t _size;
+    std::vector<uint8_t> _buffer; /* where files can not be mapped */
+
+    void unmap();
+
+    /* Bin of v in [-half, half] */
+    static uint32_t bin(float v, float half, uint32_t bins)
+    {
+        float f = (v + half) * (bins / (2.0f * half));
+        return static_cast<uint32_t>(static_cast<int32_t>(std::min(std::max(f, 0.0f), bins - 1.0f)));
+    }
+};
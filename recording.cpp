@@ -0,0 +1,230 @@
+#include "recording.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+static constexpr uint8_t MAGIC[7] = {'P', 'O', 'N', 'G', 'R', 'E', 'C'};
+static constexpr uint8_t VERSION = 3;
+static constexpr size_t HEADER_SIZE = sizeof(MAGIC) + 13; /* up to the runs, see encode() */
+static constexpr size_t RESERVED_RUNS = 4096; /* keeps record() from allocating during a usual match */
+static constexpr uint8_t KEY_BITS = 5;
+static constexpr uint8_t SHORT_RUN = (1 << (8 - KEY_BITS)) - 1; /* longer runs continue in a varint */
+
+static void writeVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static bool readVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && data < end; shift += 7)
+    {
+        auto byte = *data++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+Recording::Recording()
+    : _seed(0),
+      _physics(World::Physics::FLOAT),
+      _tickRate(World::FPS),
+      _bot(findBotSkill("normal")),
+      _ticks(0),
+      _run(0),
+      _runTicks(0)
+{
+}
+
+void Recording::start(uint64_t seed, World::Physics physics, int tickRate, const BotSkill* bot)
+{
+    _runs.clear();
+    _runs.reserve(RESERVED_RUNS);
+    _seed = seed;
+    _physics = physics;
+    _tickRate = tickRate;
+    _bot = bot ? bot : findBotSkill("normal");
+    _ticks = 0;
+    rewind();
+}
+
+void Recording::record(const Keystate& input)
+{
+    auto keys = packKeys(input);
+    if (_runs.empty() || _runs.back().keys != keys)
+    {
+        _runs.push_back({keys, 0});
+    }
+    _runs.back().count++;
+    _ticks++;
+}
+
+void Recording::rewind()
+{
+    _run = 0;
+    _runTicks = 0;
+}
+
+bool Recording::next(Keystate& input)
+{
+    if (_run == _runs.size())
+    {
+        return false;
+    }
+    input = unpackKeys(_runs[_run].keys);
+    if (++_runTicks == _runs[_run].count)
+    {
+        _run++;
+        _runTicks = 0;
+    }
+    return true;
+}
+
+uint64_t Recording::seed() const
+{
+    return _seed;
+}
+
+World::Physics Recording::physics() const
+{
+    return _physics;
+}
+
+int Recording::tickRate() const
+{
+    return _tickRate;
+}
+
+const BotSkill& Recording::bot() const
+{
+    return *_bot;
+}
+
+uint64_t Recording::ticks() const
+{
+    return _ticks;
+}
+
+/* Magic, version, seed as 8 little endian bytes, physics, tick rate as 2, bot skill index, then the runs */
+std::vector<uint8_t> Recording::encode() const
+{
+    std::vector<uint8_t> out(MAGIC, MAGIC + sizeof(MAGIC));
+    out.push_back(VERSION);
+    for (int i = 0; i < 8; i++)
+    {
+        out.push_back(static_cast<uint8_t>(_seed >> (i * 8)));
+    }
+    out.push_back(static_cast<uint8_t>(_physics));
+    out.push_back(static_cast<uint8_t>(_tickRate));
+    out.push_back(static_cast<uint8_t>(_tickRate >> 8));
+    size_t skillCount;
+    out.push_back(static_cast<uint8_t>(_bot - botSkills(&skillCount)));
+    for (const auto& run : _runs)
+    {
+        if (run.count <= SHORT_RUN)
+        {
+            out.push_back(run.keys | static_cast<uint8_t>((run.count - 1) << KEY_BITS));
+        }
+        else
+        {
+            out.push_back(run.keys | (SHORT_RUN << KEY_BITS));
+            writeVarint(out, run.count - SHORT_RUN);
+        }
+    }
+    return out;
+}
+
+bool Recording::decode(const uint8_t* data, size_t size)
+{
+    auto end = data + size;
+    if (size < HEADER_SIZE || memcmp(data, MAGIC, sizeof(MAGIC)) || data[sizeof(MAGIC)] != VERSION)
+    {
+        return false;
+    }
+    data += sizeof(MAGIC) + 1;
+
+    uint64_t seed = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        seed |= static_cast<uint64_t>(*data++) << (i * 8);
+    }
+    auto physics = *data++;
+    if (physics > static_cast<uint8_t>(World::Physics::FIXED))
+    {
+        return false;
+    }
+
+    int tickRate = data[0] | (data[1] << 8);
+    data += 2;
+    if (!tickRate)
+    {
+        return false;
+    }
+
+    size_t skillCount;
+    auto skills = botSkills(&skillCount);
+    if (*data >= skillCount)
+    {
+        return false;
+    }
+    auto bot = &skills[*data++];
+
+    start(seed, static_cast<World::Physics>(physics), tickRate, bot);
+    while (data < end)
+    {
+        auto byte = *data++;
+        Run run {static_cast<uint8_t>(byte & ((1 << KEY_BITS) - 1)), static_cast<uint64_t>(byte >> KEY_BITS) + 1};
+        if (run.count > SHORT_RUN)
+        {
+            uint64_t extra;
+            if (!readVarint(data, end, extra))
+            {
+                return false;
+            }
+            run.count = SHORT_RUN + extra;
+        }
+        _runs.push_back(run);
+        _ticks += run.count;
+    }
+    return true;
+}
+
+bool Recording::save(const char* path) const
+{
+    auto data = encode();
+    auto file = fopen(path, "wb");
+    if (!file)
+    {
+        return false;
+    }
+    bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return (fclose(file) == 0) && written;
+}
+
+bool Recording::load(const char* path)
+{
+    auto file = fopen(path, "rb");
+    if (!file)
+    {
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        data.insert(data.end(), buffer, buffer + read);
+    }
+    fclose(file);
+    return decode(data.data(), data.size());
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "world.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Input of a whole match: the seed, the physics, the tick rate, the bot skill
+ * and the Keystate of every tick, enough for World to play the match again.
+ *
+ * Inputs are kept as runs of identical Keystates. On disk a run is one byte
+ * holding the five keys and a short run length, followed by a LEB128 varint
+ * for longer runs, so a match where the keys change a few times per second
+ * takes a few bytes per second. A float physics replay is only exact on the
+ * build which recorded it, a fixed one everywhere.
+ */
+class Recording
+{
+public:
+    Recording();
+    void start(uint64_t seed, World::Physics physics, int tickRate = World::FPS, const BotSkill* bot = nullptr); /* bot from botSkills(), normal if null */
+    void record(const Keystate& input);
+    void rewind();
+    bool next(Keystate& input); /* false once every tick was replayed */
+
+    uint64_t seed() const;
+    World::Physics physics() const;
+    int tickRate() const;
+    const BotSkill& bot() const;
+    uint64_t ticks() const;
+
+    std::vector<uint8_t> encode() const;
+    bool decode(const uint8_t* data, size_t size);
+    bool save(const char* path) const;
+    bool load(const char* path);
+
+private:
+    struct Run
+    {
+        uint8_t keys;
+        uint64_t count;
+    };
+
+    std::vector<Run> _runs;
+    uint64_t _seed;
+    World::Physics _physics;
+    int _tickRate;
+    const BotSkill* _bot;
+    uint64_t _ticks;
+    size_t _run;        /* replay position */
+    uint64_t _runTicks; /* ticks of _runs[_run] already replayed */
+};
@@ -3,7 +3,10 @@
 #include <stdint.h>
 
 /*
- * Xoshiro512+
+ * Xoshiro256+
+ *
+ * jump() and longJump() advance the generator by 2^128 and 2^192 draws, so
+ * that copies taken between jumps are non-overlapping streams.
  */
 class Rng
 {
@@ -48,9 +51,44 @@ public:
         return (next() >> 11) * (1.0 / (1ULL << 53));
     }
 
+    void jump()
+    {
+        static const uint64_t JUMP[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+        jump(JUMP);
+    }
+
+    void longJump()
+    {
+        static const uint64_t LONG_JUMP[] = {0x76e15d3efefdcbbf, 0xc5004e441c522fb3, 0x77710069854ee241, 0x39109bb02acbe635};
+        jump(LONG_JUMP);
+    }
+
 private:
     uint64_t _state[4];
 
+    void jump(const uint64_t (&polynomial)[4])
+    {
+        uint64_t state[4] = {0, 0, 0, 0};
+        for (auto word : polynomial)
+        {
+            for (int bit = 0; bit < 64; bit++)
+            {
+                if (word & (1ULL << bit))
+                {
+                    for (int i = 0; i < 4; i++)
+                    {
+                        state[i] ^= _state[i];
+                    }
+                }
+                next();
+            }
+        }
+        for (int i = 0; i < 4; i++)
+        {
+            _state[i] = state[i];
+        }
+    }
+
     uint64_t rotl(const uint64_t x, int k)
     {
         return (x << k) | (x >> (64 - k));
@@ -0,0 +1,144 @@
+#include "rollback.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+static constexpr uint32_t NO_ROLLBACK = UINT32_MAX;
+
+RollbackSession::RollbackSession(World& world, Transport& transport, int side)
+    : _world(world),
+      _transport(transport),
+      _side(side),
+      _peerAck(0),
+      _rollbackFrom(NO_ROLLBACK)
+{
+    memset(_localInputs, 0, sizeof(_localInputs));
+    memset(_remoteInputs, 0, sizeof(_remoteInputs));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+/* Simulates the next tick, or returns false when too far ahead of the remote peer */
+bool RollbackSession::advance(const Keystate& local, uint8_t& events)
+{
+    events = 0;
+    _stats.depth = 0;
+    _stats.resimulateMs = 0.0;
+    receive();
+
+    if (_rollbackFrom != NO_ROLLBACK)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        _world.restore(_snapshots[_rollbackFrom % (MAX_ROLLBACK + 1)]);
+        for (auto tick = _rollbackFrom; tick < _stats.tick; tick++)
+        {
+            simulate(tick);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        _stats.depth = _stats.tick - _rollbackFrom;
+        _stats.resimulateMs = std::chrono::duration<double, std::milli>(end - begin).count();
+        _stats.rollbacks++;
+        _rollbackFrom = NO_ROLLBACK;
+    }
+
+    if (_stats.tick >= _stats.confirmed + MAX_ROLLBACK || _stats.tick - _peerAck >= INPUT_RING)
+    {
+        _stats.stalls++;
+        send(); /* the peer may be waiting for our acknowledgement */
+        return false;
+    }
+
+    _localInputs[_stats.tick % INPUT_RING] = packKeys(local);
+    events = simulate(_stats.tick);
+    _stats.tick++;
+    send();
+    return true;
+}
+
+bool RollbackSession::snapshot(uint32_t tick, WorldSnapshot& snapshot) const
+{
+    if (tick == _stats.tick)
+    {
+        _world.save(snapshot);
+        return true;
+    }
+    if (tick > _stats.tick || _stats.tick - tick > MAX_ROLLBACK)
+    {
+        return false;
+    }
+    snapshot = _snapshots[tick % (MAX_ROLLBACK + 1)];
+    return true;
+}
+
+const RollbackStats& RollbackSession::stats() const
+{
+    return _stats;
+}
+
+/*
+ * Takes the remote inputs which follow the confirmed ones, and marks the
+ * first one that differs from its prediction for a rollback.
+ */
+void RollbackSession::receive()
+{
+    InputPacket packet;
+    while (_transport.receive(packet))
+    {
+        _peerAck = std::max(_peerAck, packet.ack);
+        for (uint32_t i = 0; i < packet.count; i++)
+        {
+            auto tick = packet.first + i;
+            if (tick != _stats.confirmed)
+            {
+                continue; /* already known, or after a gap */
+            }
+            auto& input = _remoteInputs[tick % INPUT_RING];
+            if (tick < _stats.tick && input != packet.inputs[i])
+            {
+                _rollbackFrom = std::min(_rollbackFrom, tick);
+            }
+            input = packet.inputs[i];
+            _stats.confirmed++;
+        }
+    }
+
+    /* Ticks past the confirmed ones will be simulated again with the newest input */
+    if (_rollbackFrom != NO_ROLLBACK)
+    {
+        auto last = _remoteInputs[(_stats.confirmed - 1) % INPUT_RING];
+        for (auto tick = _stats.confirmed; tick < _stats.tick; tick++)
+        {
+            _remoteInputs[tick % INPUT_RING] = last;
+        }
+    }
+}
+
+/* Every local input the peer has not acknowledged yet */
+void RollbackSession::send()
+{
+    InputPacket packet;
+    packet.ack = _stats.confirmed;
+    packet.first = _peerAck;
+    packet.count = static_cast<uint8_t>(std::min<uint32_t>(_stats.tick - _peerAck, InputPacket::MAX_INPUTS));
+    for (uint32_t i = 0; i < packet.count; i++)
+    {
+        packet.inputs[i] = _localInputs[(packet.first + i) % INPUT_RING];
+    }
+    _transport.send(packet);
+}
+
+/* Saves the state before tick, then plays it with the known or predicted remote input */
+uint8_t RollbackSession::simulate(uint32_t tick)
+{
+    if (tick >= _stats.confirmed)
+    {
+        _remoteInputs[tick % INPUT_RING] = _stats.confirmed ? _remoteInputs[(_stats.confirmed - 1) % INPUT_RING] : 0;
+    }
+    _world.save(_snapshots[tick % (MAX_ROLLBACK + 1)]);
+
+    Keystate inputs[2];
+    inputs[_side] = unpackKeys(_localInputs[tick % INPUT_RING]);
+    inputs[1 - _side] = unpackKeys(_remoteInputs[tick % INPUT_RING]);
+    return _world.tick(inputs[0], inputs[1]);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "snapshot.hpp"
+#include "transport.hpp"
+#include "world.hpp"
+#include <stdint.h>
+
+struct RollbackStats
+{
+    uint32_t tick;       /* next tick to simulate */
+    uint32_t confirmed;  /* remote inputs are known for every tick before this one */
+    int depth;           /* ticks simulated again by the last advance() */
+    double resimulateMs; /* time the last advance() spent simulating them */
+    uint64_t rollbacks;
+    uint64_t stalls; /* advance() calls which waited for the remote peer */
+};
+
+/*
+ * Rollback netcode for a two player World, one session per peer.
+ *
+ * Every tick runs right away with the local input and a prediction of the
+ * remote one: the last remote input received, repeated. The state before each
+ * tick is kept in a ring of snapshots. When a remote input arrives which does
+ * not match its prediction, the World goes back to the snapshot of that tick
+ * and simulates again up to the present, within the same advance().
+ *
+ * A peer never runs more than MAX_ROLLBACK ticks ahead of the remote inputs
+ * it has: advance() then stalls and returns false until they arrive, which
+ * also bounds the work of a rollback.
+ *
+ * Both peers must start from the same seed and physics, side being the
+ * paddle played locally (0 left, 1 right).
+ */
+class RollbackSession
+{
+public:
+    static constexpr auto MAX_ROLLBACK = 16;
+    static constexpr auto INPUT_RING = 256; /* local inputs kept until acknowledged */
+
+    RollbackSession(World& world, Transport& transport, int side);
+    bool advance(const Keystate& local, uint8_t& events);
+    bool snapshot(uint32_t tick, WorldSnapshot& snapshot) const; /* state before tick, if still kept */
+    const RollbackStats& stats() const;
+
+private:
+    World& _world;
+    Transport& _transport;
+    int _side;
+    uint8_t _localInputs[INPUT_RING];
+    uint8_t _remoteInputs[INPUT_RING]; /* received before _confirmed, predicted after */
+    WorldSnapshot _snapshots[MAX_ROLLBACK + 1];
+    uint32_t _peerAck; /* the peer has every local input before this tick */
+    uint32_t _rollbackFrom;
+    RollbackStats _stats;
+
+    void receive();
+    void send();
+    uint8_t simulate(uint32_t tick);
+};
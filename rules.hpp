@@ -0,0 +1,16 @@
+#pragma once
+
+/*
+ * Playfield geometry and speeds, shared by the game and the headless
+ * simulators. The field spans [-GAME_WIDTH/2, GAME_WIDTH/2] horizontally and
+ * [-GAME_HEIGHT/2, GAME_HEIGHT/2] vertically, y pointing down.
+ */
+static constexpr auto GAME_WIDTH = 1.77f; /* 16:9 screen ratio */
+static constexpr auto GAME_HEIGHT = 1.0f;
+static constexpr auto BALL_SPEED = 0.75f;
+static constexpr auto PADDLE_SPEED = BALL_SPEED * 0.8f;
+static constexpr auto BALL_SIZE = 0.05f;
+static constexpr auto PADDLE_WIDTH = BALL_SIZE;
+static constexpr auto PADDLE_HEIGHT = 0.2f;
+static constexpr auto PADDLE_INSET = 0.1f; /* distance between a paddle center and its side of the field */
+static constexpr auto WALL_THICKNESS = 0.1f;
@@ -0,0 +1,121 @@
+#include "scheduler.hpp"
+
+#include "world.hpp"
+
+Scheduler::Scheduler()
+    : _tickRate(World::FPS),
+      _frameRate(World::FPS),
+      _maxCatchUp(5),
+      _policy(Policy::DROP),
+      _timeScale(1.0),
+      _frameStart(0),
+      _lag(0),
+      _stats {0, 0, 0, 0, 0}
+{
+}
+
+/* Keeps the time already accumulated, in seconds */
+void Scheduler::setTickRate(uint32_t hz)
+{
+    _lag = _lag / _tickRate * hz;
+    _tickRate = hz;
+}
+
+uint32_t Scheduler::tickRate() const
+{
+    return _tickRate;
+}
+
+void Scheduler::setFrameRate(uint32_t hz)
+{
+    _frameRate = hz;
+}
+
+uint32_t Scheduler::frameRate() const
+{
+    return _frameRate;
+}
+
+void Scheduler::setMaxCatchUp(int ticks)
+{
+    _maxCatchUp = ticks;
+}
+
+int Scheduler::maxCatchUp() const
+{
+    return _maxCatchUp;
+}
+
+void Scheduler::setPolicy(Policy policy)
+{
+    _policy = policy;
+}
+
+void Scheduler::setTimeScale(double scale)
+{
+    _timeScale = scale;
+}
+
+void Scheduler::start(uint64_t now)
+{
+    _frameStart = now;
+    _lag = 0;
+}
+
+/* Accumulates the time since the last frame and returns how many ticks to run */
+int Scheduler::beginFrame(uint64_t now)
+{
+    uint64_t elapsed = now - _frameStart;
+    _frameStart = now;
+    _stats.frameNs = elapsed;
+    if (_timeScale != 1.0)
+    {
+        elapsed = static_cast<uint64_t>(elapsed * _timeScale);
+    }
+
+    uint64_t limit = (_maxCatchUp * SECOND) / _tickRate;
+    if (_policy == Policy::SLOW_DOWN && elapsed > limit)
+    {
+        _stats.slowed += elapsed - limit;
+        elapsed = limit;
+    }
+    _lag += elapsed * _tickRate;
+
+    uint64_t ticks = _lag / SECOND;
+    if (ticks > static_cast<uint64_t>(_maxCatchUp))
+    {
+        _stats.dropped += ticks - _maxCatchUp;
+        ticks = _maxCatchUp;
+        _lag %= SECOND;
+    }
+    else
+    {
+        _lag -= ticks * SECOND;
+    }
+
+    _stats.ticks += ticks;
+    _stats.frameTicks = static_cast<int>(ticks);
+    return _stats.frameTicks;
+}
+
+double Scheduler::alpha() const
+{
+    return static_cast<double>(_lag) / SECOND;
+}
+
+/* How long to wait before the next frame to hold the frame rate */
+uint64_t Scheduler::frameDelay(uint64_t now) const
+{
+    if (!_frameRate)
+    {
+        return 0;
+    }
+    uint64_t spent = now - _frameStart;
+    uint64_t frame = SECOND / _frameRate;
+    return spent < frame ? frame - spent : 0;
+}
+
+const Scheduler::Stats& Scheduler::stats() const
+{
+    return _stats;
+}
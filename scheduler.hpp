@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Fixed timestep scheduler: turns the wall clock into a number of ticks to
+ * simulate each frame.
+ *
+ * Time is kept in integers: elapsed nanoseconds are accumulated multiplied by
+ * the tick rate, and a tick costs a billion of these units, so any tick rate
+ * is exact and nothing drifts however long the game runs.
+ *
+ * A frame never runs more than maxCatchUp ticks. When more time has passed,
+ * after a stall or on a machine too slow for the tick rate, the policy says
+ * what happens to the rest:
+ *  - DROP: it is thrown away and counted as dropped ticks. The game skips
+ *    ahead and stays in step with the wall clock.
+ *  - SLOW_DOWN: frame time is capped before it is accumulated. The game runs
+ *    slower than the wall clock instead, and resumes where it was after a
+ *    stall.
+ *
+ * The frame rate only matters without vsync, for frameDelay().
+ */
+class Scheduler
+{
+public:
+    enum class Policy : uint8_t
+    {
+        DROP,
+        SLOW_DOWN,
+    };
+
+    struct Stats
+    {
+        uint64_t ticks;
+        uint64_t dropped; /* ticks thrown away by DROP */
+        uint64_t slowed;  /* ns of wall clock not simulated by SLOW_DOWN */
+        uint64_t frameNs; /* wall clock since the previous frame */
+        int frameTicks;   /* ticks to run during the current frame */
+    };
+
+    static constexpr uint64_t SECOND = 1000000000;
+    static constexpr double MAX_TIME_SCALE = 1000.0; /* keeps scaled frame times far from overflowing */
+
+    Scheduler();
+    void setTickRate(uint32_t hz);
+    uint32_t tickRate() const;
+    void setFrameRate(uint32_t hz); /* 0 for no limit */
+    uint32_t frameRate() const;
+    void setMaxCatchUp(int ticks); /* at least 1 */
+    int maxCatchUp() const;
+    void setPolicy(Policy policy);
+    void setTimeScale(double scale); /* above 0, at most MAX_TIME_SCALE */
+
+    void start(uint64_t now);
+    int beginFrame(uint64_t now);
+    double alpha() const; /* time past the last tick, in ticks, in [0, 1) */
+    uint64_t frameDelay(uint64_t now) const;
+    const Stats& stats() const;
+
+private:
+    uint32_t _tickRate;
+    uint32_t _frameRate;
+    int _maxCatchUp;
+    Policy _policy;
+    double _timeScale;
+    uint64_t _frameStart; /* ns */
+    uint64_t _lag;        /* ns times _tickRate */
+    Stats _stats;
+};
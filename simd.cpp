@@ -0,0 +1,26 @@
+#include "simd.hpp"
+
+#ifdef SIMD_X86
+bool cpuHasAvx2()
+{
+#    ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = info[2] & (1 << 27);
+    bool avx = info[2] & (1 << 28);
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+    {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 5);
+#    else
+    return __builtin_cpu_supports("avx2");
+#    endif
+}
+#endif
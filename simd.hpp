@@ -0,0 +1,31 @@
+#pragma once
+
+/*
+ * x86 SIMD support shared by the kernels. Kernels are built for the baseline
+ * target and the AVX2 ones are tagged with TARGET_AVX2, then picked at runtime
+ * with cpuHasAvx2().
+ */
+#if defined(__x86_64__) || defined(_M_X64)
+#    define SIMD_X86 1
+#    include <immintrin.h>
+#    ifdef _MSC_VER
+#        include <intrin.h>
+#        define TARGET_AVX2
+#    else
+#        define TARGET_AVX2 __attribute__((target("avx2")))
+#    endif
+
+bool cpuHasAvx2();
+
+/* Index of the lowest set bit of a non-zero movemask */
+inline int lowestBit(unsigned mask)
+{
+#    ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#    else
+    return __builtin_ctz(mask);
+#    endif
+}
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "fixedworld.hpp"
+#include "world.hpp"
+#include <glm/glm.hpp>
+#include <stdint.h>
+#include <type_traits>
+
+/*
+ * Everything that changes while a World plays a match, in one fixed-size,
+ * trivially copyable block: copying, storing or comparing a snapshot is a
+ * single memcpy or memcmp.
+ *
+ * Walls, separators and the static grid never change during a match, so only
+ * the bodies which move are kept. The broadphase keeps no state that changes
+ * the outcome of a tick and is left alone. fixed is only used, and otherwise
+ * zeroed, with Physics::FIXED.
+ */
+struct WorldSnapshot
+{
+    static constexpr auto BODIES = 3; /* the ball, then the left and right paddles */
+
+    struct Body
+    {
+        glm::vec2 pos;
+        glm::vec2 v;
+        uint32_t flags;
+        uint16_t idleTicks;
+    };
+
+    Body bodies[BODIES];
+    World::State world;
+    FixedWorld::State fixed;
+};
+
+static_assert(std::is_trivially_copyable<WorldSnapshot>::value, "snapshots are copied with memcpy");
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cmath>
+#include <glm/glm.hpp>
+
+struct SweepHit
+{
+    float t;          /* fraction of the motion at which the boxes start touching */
+    glm::vec2 normal; /* face normal of b at the impact, pointing towards a */
+};
+
+/*
+ * Swept AABB test: box a moving by d against a box b at rest (pass the
+ * relative motion if both move). Finds the first time of impact in [0, 1]
+ * by clipping the motion against b grown by the half size of a.
+ *
+ * Boxes that already overlap, or only slide along each other, are not a hit:
+ * the discrete narrowphase deals with them.
+ */
+inline bool sweep(glm::vec2 aPos, glm::vec2 aSize, glm::vec2 d, glm::vec2 bPos, glm::vec2 bSize, SweepHit& hit)
+{
+    glm::vec2 extent = aSize * 0.5f + bSize * 0.5f;
+    float tEnter = -1.0f;
+    float tExit = 2.0f;
+    glm::vec2 normal {0.0f, 0.0f};
+
+    for (int axis = 0; axis < 2; axis++)
+    {
+        float gap = aPos[axis] - bPos[axis];
+        if (d[axis] == 0.0f)
+        {
+            if (std::abs(gap) >= extent[axis])
+            {
+                return false;
+            }
+            continue;
+        }
+
+        float t1 = (-extent[axis] - gap) / d[axis];
+        float t2 = (extent[axis] - gap) / d[axis];
+        float tNear = t1 < t2 ? t1 : t2;
+        float tFar = t1 < t2 ? t2 : t1;
+        if (tNear > tEnter)
+        {
+            tEnter = tNear;
+            normal = {0.0f, 0.0f};
+            normal[axis] = d[axis] > 0.0f ? -1.0f : 1.0f;
+        }
+        if (tFar < tExit)
+        {
+            tExit = tFar;
+        }
+    }
+
+    if (tEnter >= tExit || tEnter < 0.0f || tEnter > 1.0f)
+    {
+        return false;
+    }
+
+    hit.t = tEnter;
+    hit.normal = normal;
+    return true;
+}
@@ -0,0 +1,139 @@
+#include "tournament.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static constexpr double ELO_BASE = 1500.0;
+static constexpr int ELO_ITERATIONS = 10000;
+
+/*
+ * Bradley-Terry fit by minorization-maximization: the strength of a policy
+ * is its score over the sum of its games weighted by 1 / (own + opponent
+ * strength), until the strengths settle. Elo is 400 log10 of the strength.
+ */
+static void rate(TournamentResult& result, size_t count)
+{
+    /* games[i * count + j] and scores[i * count + j]: between i and j, scored by i */
+    std::vector<double> games(count * count);
+    std::vector<double> scores(count * count);
+    for (size_t i = 0; i < count; i++)
+    {
+        for (size_t j = 0; j < count; j++)
+        {
+            if (i == j)
+            {
+                continue;
+            }
+            const auto& home = result.pairings[(i * count) + j];
+            const auto& away = result.pairings[(j * count) + i];
+            games[(i * count) + j] = static_cast<double>(home.matches + away.matches) + 1.0;
+            scores[(i * count) + j] = static_cast<double>(home.wins[0] + away.wins[1]) + ((home.draws + away.draws + 1.0) / 2.0);
+        }
+    }
+
+    std::vector<double> strengths(count, 1.0);
+    std::vector<double> next(count);
+    for (int iteration = 0; count > 1 && iteration < ELO_ITERATIONS; iteration++)
+    {
+        double logSum = 0.0;
+        for (size_t i = 0; i < count; i++)
+        {
+            double score = 0.0;
+            double weight = 0.0;
+            for (size_t j = 0; j < count; j++)
+            {
+                if (i != j)
+                {
+                    score += scores[(i * count) + j];
+                    weight += games[(i * count) + j] / (strengths[i] + strengths[j]);
+                }
+            }
+            next[i] = score / weight;
+            logSum += std::log(next[i]);
+        }
+
+        /* Geometric mean of 1, the fit only knows differences */
+        double scale = std::exp(logSum / count);
+        double change = 0.0;
+        for (size_t i = 0; i < count; i++)
+        {
+            next[i] /= scale;
+            change = std::max(change, std::abs(std::log(next[i] / strengths[i])));
+        }
+        strengths.swap(next);
+        if (change < 1e-12)
+        {
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        result.standings[i].elo = ELO_BASE + (400.0 * std::log10(strengths[i]));
+    }
+}
+
+TournamentResult playTournament(MatchFarm& farm, const TournamentSetup& setup)
+{
+    auto count = setup.count;
+    TournamentResult result {};
+    result.standings.resize(count);
+    result.pairings.resize(count * count);
+
+    std::vector<FarmSetup> farmSetups;
+    std::vector<size_t> pairings;
+    Rng seeds(setup.seed);
+    for (size_t left = 0; left < count; left++)
+    {
+        for (size_t right = 0; right < count; right++)
+        {
+            if (left == right)
+            {
+                continue;
+            }
+            const auto& l = setup.policies[left];
+            const auto& r = setup.policies[right];
+            FarmSetup farmSetup {l.controller, r.controller, BALL_SPEED, PADDLE_SPEED, setup.matches, setup.ticks, seeds.next()};
+            farmSetup.skills[0] = l.skill;
+            farmSetup.skills[1] = r.skill;
+            farmSetup.policies[0] = l.policy;
+            farmSetup.policies[1] = r.policy;
+            farmSetup.tables[0] = l.table;
+            farmSetup.tables[1] = r.table;
+            farmSetups.push_back(farmSetup);
+            pairings.push_back((left * count) + right);
+        }
+    }
+
+    std::vector<FarmResult> farmResults(farmSetups.size());
+    farm.sweep(farmSetups.data(), farmSetups.size(), farmResults.data());
+
+    for (size_t k = 0; k < pairings.size(); k++)
+    {
+        const auto& pairing = farmResults[k];
+        auto left = pairings[k] / count;
+        auto right = pairings[k] % count;
+        result.pairings[pairings[k]] = pairing;
+        result.matches += pairing.matches;
+        result.ticks += pairing.ticks;
+
+        size_t sides[2] = {left, right};
+        for (int side = 0; side < 2; side++)
+        {
+            auto& standing = result.standings[sides[side]];
+            standing.matches += pairing.matches;
+            standing.wins += pairing.wins[side];
+            standing.draws += pairing.draws;
+            standing.losses += pairing.wins[1 - side];
+            standing.pointsFor += pairing.points[side];
+            standing.pointsAgainst += pairing.points[1 - side];
+            for (size_t bin = 0; bin < FarmResult::RALLY_BINS; bin++)
+            {
+                standing.rallies[bin] += pairing.rallies[bin];
+            }
+        }
+    }
+
+    rate(result, count);
+    return result;
+}
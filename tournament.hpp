@@ -0,0 +1,60 @@
+#pragma once
+
+#include "matchfarm.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/* Who plays a paddle in a tournament */
+struct PaddlePolicy
+{
+    const char* name;
+    BatchSim::Controller controller;
+    const BotSkill* skill;            /* of a BOT, normal when null */
+    const MlpPolicy* policy = nullptr; /* of an MLP */
+    const PolicyTable* table = nullptr; /* of a TABLE */
+};
+
+struct TournamentSetup
+{
+    const PaddlePolicy* policies;
+    size_t count;
+    size_t matches; /* per pairing and side */
+    size_t ticks;   /* length of a match */
+    uint64_t seed;
+};
+
+struct Standing
+{
+    uint64_t matches;
+    uint64_t wins;
+    uint64_t draws;
+    uint64_t losses;
+    uint64_t pointsFor;
+    uint64_t pointsAgainst;
+    double elo;
+    uint64_t rallies[FarmResult::RALLY_BINS]; /* of the matches it played */
+};
+
+struct TournamentResult
+{
+    std::vector<Standing> standings;  /* in the order of the policies */
+    std::vector<FarmResult> pairings; /* [left * count + right], the diagonal is not played */
+    uint64_t matches;
+    uint64_t ticks;
+};
+
+/*
+ * Round robin: every policy plays every other one, setup.matches times on
+ * each side, all pairings queued on the farm at once.
+ *
+ * The farm seed of pairing k is the k-th draw of an Rng seeded with
+ * setup.seed, so a match depends on the setup only, not on the number of
+ * threads nor on the other pairings.
+ *
+ * Elo ratings are the maximum likelihood fit of the results (a draw counts
+ * as half a win), centered on 1500. They do not depend on the order of the
+ * matches. Each pairing also counts one virtual draw, which keeps the rating
+ * of a policy winning every match finite.
+ */
+TournamentResult playTournament(MatchFarm& farm, const TournamentSetup& setup);
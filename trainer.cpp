@@ -0,0 +1,132 @@
+#include "trainer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static constexpr double ADAM_BETA1 = 0.9;
+static constexpr double ADAM_BETA2 = 0.999;
+static constexpr double ADAM_EPSILON = 1e-8;
+
+/* Standard normal draw, Box-Muller */
+static float gaussian(Rng& rng)
+{
+    static constexpr double TWO_PI = 6.283185307179586;
+    double u = 1.0 - rng.dnext(); /* (0, 1], for the log */
+    double v = rng.dnext();
+    return static_cast<float>(std::sqrt(-2.0 * std::log(u)) * std::cos(TWO_PI * v));
+}
+
+EvolutionTrainer::EvolutionTrainer(JobPool& pool, const TrainerSetup& setup, const MlpPolicy& initial)
+    : _pool(pool),
+      _setup(setup),
+      _policy(initial),
+      _rng(setup.seed),
+      _generation(0),
+      _noise((setup.population / 2) * MlpPolicy::PARAMETERS),
+      _candidates(setup.population),
+      _fitness(setup.population),
+      _moments {std::vector<double>(MlpPolicy::PARAMETERS), std::vector<double>(MlpPolicy::PARAMETERS)}
+{
+}
+
+/* Points won minus points lost per match, playing the right paddle */
+double EvolutionTrainer::evaluate(const MlpPolicy& policy, uint64_t seed) const
+{
+    BatchSim sim(_setup.matches, seed, _setup.opponent, BatchSim::MLP);
+    sim.setPolicy(1, policy);
+    if (_setup.skill)
+    {
+        sim.setSkill(0, *_setup.skill);
+    }
+    for (size_t t = 0; t < _setup.ticks; t++)
+    {
+        sim.tick();
+    }
+
+    /* The BatchSim may round its lanes up, the extra ones are not counted */
+    int64_t balance = 0;
+    for (size_t lane = 0; lane < _setup.matches; lane++)
+    {
+        balance += sim.scores(1)[lane] - sim.scores(0)[lane];
+    }
+    return static_cast<double>(balance) / _setup.matches;
+}
+
+double EvolutionTrainer::step()
+{
+    static constexpr auto P = MlpPolicy::PARAMETERS;
+    auto pairs = _setup.population / 2;
+    for (auto& noise : _noise)
+    {
+        noise = gaussian(_rng);
+    }
+    for (size_t k = 0; k < pairs; k++)
+    {
+        for (int sign = 0; sign < 2; sign++)
+        {
+            auto& candidate = _candidates[(2 * k) + sign];
+            auto scale = sign ? -_setup.sigma : _setup.sigma;
+            for (size_t p = 0; p < P; p++)
+            {
+                candidate.parameters()[p] = _policy.parameters()[p] + (scale * _noise[(k * P) + p]);
+            }
+        }
+    }
+
+    auto seed = _rng.next();
+    for (size_t c = 0; c < _setup.population; c++)
+    {
+        _pool.submit([this, c, seed](size_t) { _fitness[c] = evaluate(_candidates[c], seed); });
+    }
+    _pool.wait();
+
+    /* Centered ranks in [-0.5, 0.5], ties broken by candidate */
+    std::vector<size_t> order(_setup.population);
+    for (size_t c = 0; c < order.size(); c++)
+    {
+        order[c] = c;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return _fitness[a] < _fitness[b]; });
+    std::vector<double> ranks(_setup.population);
+    for (size_t r = 0; r < order.size(); r++)
+    {
+        ranks[order[r]] = (order.size() > 1) ? (static_cast<double>(r) / (order.size() - 1)) - 0.5 : 0.0;
+    }
+
+    _generation++;
+    for (size_t p = 0; p < P; p++)
+    {
+        double gradient = 0.0;
+        for (size_t k = 0; k < pairs; k++)
+        {
+            gradient += (ranks[2 * k] - ranks[(2 * k) + 1]) * _noise[(k * P) + p];
+        }
+        gradient /= _setup.population * _setup.sigma;
+
+        /* Ascent, the fitness is maximized */
+        auto& m = _moments[0][p];
+        auto& v = _moments[1][p];
+        m = (ADAM_BETA1 * m) + ((1.0 - ADAM_BETA1) * gradient);
+        v = (ADAM_BETA2 * v) + ((1.0 - ADAM_BETA2) * gradient * gradient);
+        double mHat = m / (1.0 - std::pow(ADAM_BETA1, static_cast<double>(_generation)));
+        double vHat = v / (1.0 - std::pow(ADAM_BETA2, static_cast<double>(_generation)));
+        _policy.parameters()[p] += static_cast<float>(_setup.learningRate * mHat / (std::sqrt(vHat) + ADAM_EPSILON));
+    }
+
+    double sum = 0.0;
+    for (auto fitness : _fitness)
+    {
+        sum += fitness;
+    }
+    return sum / _setup.population;
+}
+
+const MlpPolicy& EvolutionTrainer::policy() const
+{
+    return _policy;
+}
+
+size_t EvolutionTrainer::generation() const
+{
+    return _generation;
+}
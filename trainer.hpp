@@ -0,0 +1,57 @@
+#pragma once
+
+#include "batchsim.hpp"
+#include "jobs.hpp"
+#include "mlp.hpp"
+#include "rng.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+struct TrainerSetup
+{
+    BatchSim::Controller opponent;
+    const BotSkill* skill; /* of a BOT opponent, normal when null */
+    size_t population;     /* candidates per generation, even */
+    size_t matches;        /* played by each candidate */
+    size_t ticks;          /* length of a match */
+    float sigma;           /* standard deviation of the parameter noise */
+    float learningRate;
+    uint64_t seed;
+};
+
+/*
+ * Evolution strategies for an MlpPolicy.
+ *
+ * Each generation draws population / 2 Gaussian noise vectors and plays the
+ * policy moved by plus and minus sigma times each of them, every candidate
+ * on its own job of the pool: setup.matches BatchSim lanes against the
+ * opponent, the policy playing the right paddle. The fitness of a candidate
+ * is the points it won minus the points it lost per match.
+ *
+ * All candidates of a generation play the same serves, so that they differ
+ * by their parameters only. Fitnesses are replaced by their centered ranks
+ * and the policy follows the resulting gradient estimate with Adam. The
+ * noise and the serves come from setup.seed, so a training run does not
+ * depend on the number of threads.
+ */
+class EvolutionTrainer
+{
+public:
+    EvolutionTrainer(JobPool& pool, const TrainerSetup& setup, const MlpPolicy& initial = MlpPolicy());
+    double step(); /* plays a generation, returns the mean fitness of its candidates */
+    double evaluate(const MlpPolicy& policy, uint64_t seed) const;
+    const MlpPolicy& policy() const;
+    size_t generation() const;
+
+private:
+    JobPool& _pool;
+    TrainerSetup _setup;
+    MlpPolicy _policy;
+    Rng _rng;
+    size_t _generation;
+    std::vector<float> _noise; /* population / 2 vectors of PARAMETERS */
+    std::vector<MlpPolicy> _candidates;
+    std::vector<double> _fitness;
+    std::vector<double> _moments[2]; /* of Adam */
+};
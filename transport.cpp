@@ -0,0 +1,76 @@
+#include "transport.hpp"
+
+#include <algorithm>
+
+LoopbackLink::LoopbackLink(const LinkConditions& conditions, uint64_t seed)
+    : _conditions(conditions),
+      _rng(seed),
+      _now(0),
+      _sent(0),
+      _dropped(0),
+      _ends {End(*this, 0), End(*this, 1)}
+{
+    _inFlight[0].reserve(256);
+    _inFlight[1].reserve(256);
+}
+
+Transport& LoopbackLink::end(int side)
+{
+    return _ends[side];
+}
+
+void LoopbackLink::setTime(uint64_t ns)
+{
+    _now = ns;
+}
+
+uint64_t LoopbackLink::sent() const
+{
+    return _sent;
+}
+
+uint64_t LoopbackLink::dropped() const
+{
+    return _dropped;
+}
+
+/* Earliest arrival on top of the heaps, ties in sending order */
+bool LoopbackLink::arrivesLater(const InFlight& a, const InFlight& b)
+{
+    return a.arrival > b.arrival || (a.arrival == b.arrival && a.sequence > b.sequence);
+}
+
+LoopbackLink::End::End(LoopbackLink& link, int side)
+    : _link(link),
+      _side(side)
+{
+}
+
+void LoopbackLink::End::send(const InputPacket& packet)
+{
+    auto& link = _link;
+    link._sent++;
+    if (link._rng.dnext() < link._conditions.loss)
+    {
+        link._dropped++;
+        return;
+    }
+
+    double delayMs = link._conditions.latencyMs + (link._rng.dnext() * link._conditions.jitterMs);
+    auto& queue = link._inFlight[1 - _side];
+    queue.push_back({link._now + static_cast<uint64_t>(delayMs * 1e6), link._sent, packet});
+    std::push_heap(queue.begin(), queue.end(), arrivesLater);
+}
+
+bool LoopbackLink::End::receive(InputPacket& packet)
+{
+    auto& queue = _link._inFlight[_side];
+    if (queue.empty() || queue.front().arrival > _link._now)
+    {
+        return false;
+    }
+    std::pop_heap(queue.begin(), queue.end(), arrivesLater);
+    packet = queue.back().packet;
+    queue.pop_back();
+    return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "rng.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Inputs of one peer for consecutive ticks, starting at first. Every packet
+ * repeats all the inputs the other peer has not acknowledged yet, so a lost
+ * packet only delays them until the next one.
+ */
+struct InputPacket
+{
+    static constexpr auto MAX_INPUTS = 64;
+
+    uint32_t ack;   /* the sender has every input of the receiver before this tick */
+    uint32_t first; /* tick of inputs[0] */
+    uint8_t count;
+    uint8_t inputs[MAX_INPUTS]; /* packKeys() */
+};
+
+/* Unreliable, unordered delivery of input packets to the other peer */
+class Transport
+{
+public:
+    virtual ~Transport() = default;
+    virtual void send(const InputPacket& packet) = 0;
+    virtual bool receive(InputPacket& packet) = 0; /* false when nothing arrived yet */
+};
+
+struct LinkConditions
+{
+    static constexpr double MAX_DELAY_MS = 10000.0; /* of the latency and the jitter each */
+
+    double latencyMs; /* one way, in [0, MAX_DELAY_MS] */
+    double jitterMs;  /* added to the latency, uniform in [0, jitterMs), same range */
+    double loss;      /* probability to drop a packet, in [0, 1] */
+};
+
+/*
+ * Both ends of an in-process connection between two peers, for testing
+ * rollback without a network. Packets take latency plus jitter to arrive,
+ * so they can overtake each other, and a fraction of them is dropped.
+ *
+ * Time only moves with setTime(), so a run is reproducible from the seed.
+ */
+class LoopbackLink
+{
+public:
+    LoopbackLink(const LinkConditions& conditions, uint64_t seed);
+    Transport& end(int side);
+    void setTime(uint64_t ns);
+    uint64_t sent() const;
+    uint64_t dropped() const;
+
+private:
+    struct InFlight
+    {
+        uint64_t arrival; /* ns */
+        uint64_t sequence;
+        InputPacket packet;
+    };
+
+    class End : public Transport
+    {
+    public:
+        End(LoopbackLink& link, int side);
+        void send(const InputPacket& packet) override;
+        bool receive(InputPacket& packet) override;
+
+    private:
+        LoopbackLink& _link;
+        int _side;
+    };
+
+    LinkConditions _conditions;
+    Rng _rng;
+    uint64_t _now;
+    uint64_t _sent;
+    uint64_t _dropped;
+    std::vector<InFlight> _inFlight[2]; /* heaps of the packets travelling to each side */
+    End _ends[2];
+
+    static bool arrivesLater(const InFlight& a, const InFlight& b);
+};
@@ -0,0 +1,787 @@
+#include "world.hpp"
+
+#include "fixedworld.hpp"
+#include "mlp.hpp"
+#include "policytable.hpp"
+#include "rules.hpp"
+#include "snapshot.hpp"
+#include "sweep.hpp"
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+World::World()
+    : _entities(MAX_ENTITIES),
+      _prevPos(MAX_ENTITIES),
+      _staticGrid({-1.0f, -0.6f}, {1.0f, 0.6f}, 0.25f),
+      _broadphase(createBroadphase("sap")),
+      _narrowphase(selectNarrowphase()),
+      _tickArena(ARENA_SIZE),
+      _players(1),
+      _balls(1),
+      _botSkill(*findBotSkill("normal")),
+      _policy(nullptr),
+      _table(nullptr),
+      _tickRate(FPS),
+      _dt(dT),
+      _state {{0, 0}, Rng(), true, {}},
+      _ball(Entities::NONE),
+      _paddles {Entities::NONE, Entities::NONE},
+      _events(0),
+      _serve(false),
+      _awakeCount(0),
+      _movingCount(0),
+      _pairTests(0),
+      _contactCount(0)
+{
+    memset(_input, 0, sizeof(_input));
+}
+
+World::~World()
+{
+}
+
+void World::setPhysics(Physics physics)
+{
+    if (physics == Physics::FIXED)
+    {
+        _fixed = std::make_unique<FixedWorld>();
+        _fixed->setTickRate(_tickRate);
+    }
+    else
+    {
+        _fixed.reset();
+    }
+}
+
+World::Physics World::physics() const
+{
+    return _fixed ? Physics::FIXED : Physics::FLOAT;
+}
+
+void World::setPlayers(int players)
+{
+    _players = players;
+}
+
+int World::players() const
+{
+    return _players;
+}
+
+/* Makes room for the extra balls */
+void World::setBalls(size_t balls)
+{
+    _balls = balls;
+    _entities = Entities(MAX_ENTITIES + balls);
+    _prevPos.resize(MAX_ENTITIES + balls);
+}
+
+size_t World::balls() const
+{
+    return _balls;
+}
+
+void World::setBotSkill(const BotSkill& skill)
+{
+    _botSkill = skill;
+}
+
+void World::setPolicy(const MlpPolicy* policy)
+{
+    _policy = policy;
+}
+
+void World::setTable(const PolicyTable* table)
+{
+    _table = table;
+}
+
+void World::setTickRate(int hz)
+{
+    _tickRate = hz;
+    _dt = 1.0f / hz;
+    if (_fixed)
+    {
+        _fixed->setTickRate(hz);
+    }
+}
+
+int World::tickRate() const
+{
+    return _tickRate;
+}
+
+float World::dt() const
+{
+    return _dt;
+}
+
+/* Spawns the playfield, seed drives the serves */
+void World::init(uint64_t seed)
+{
+    _state.rng.seed(seed);
+    _state.bots[0] = {};
+    _state.bots[1] = {};
+    if (_fixed)
+    {
+        _fixed->init(seed, _players);
+    }
+
+    /* Separator lines */
+    for (int i = 0; i < 21; i++)
+    {
+        _entities.spawn({0.0f, -0.5f + (i * 0.05f)}, {0.005f, 0.03f}, {0.5f, 0.5f, 0.5f}, Entities::DISPLAY);
+    }
+
+    Entities::Handle entity;
+
+    /* Left wall */
+    entity = _entities.spawn({(-GAME_WIDTH / 2.0f) - (WALL_THICKNESS / 2.0f), 0.0f},
+                              {WALL_THICKNESS, GAME_HEIGHT + (WALL_THICKNESS * 2.0f)},
+                              {1.0f, 0.5f, 1.0f},
+                              Entities::PHYSICS | Entities::STATIC,
+                              {Behavior::SCORE_WALL, Behavior::STATIC, 1});
+    _entities.name(entity) = "leftwall";
+
+    /* Right wall */
+    entity = _entities.spawn({(GAME_WIDTH / 2.0f) + (WALL_THICKNESS / 2.0f), 0.0f},
+                              {WALL_THICKNESS, GAME_HEIGHT + (WALL_THICKNESS * 2.0f)},
+                              {1.0f, 0.5f, 1.0f},
+                              Entities::PHYSICS | Entities::STATIC,
+                              {Behavior::SCORE_WALL, Behavior::STATIC, 0});
+    _entities.name(entity) = "rightwall";
+
+    /* Top wall */
+    entity = _entities.spawn({0.0f, (-GAME_HEIGHT / 2.0f) - (WALL_THICKNESS / 2.0f)}, {GAME_WIDTH, WALL_THICKNESS}, {0.5f, 1.0f, 1.0f}, Entities::PHYSICS | Entities::STATIC, {Behavior::BOUNCE_WALL, Behavior::STATIC});
+    _entities.name(entity) = "topwall";
+
+    /* Bottom wall */
+    entity = _entities.spawn({0.0f, (GAME_HEIGHT / 2.0f) + (WALL_THICKNESS / 2.0f)}, {GAME_WIDTH, WALL_THICKNESS}, {0.5f, 1.0f, 1.0f}, Entities::PHYSICS | Entities::STATIC, {Behavior::BOUNCE_WALL, Behavior::STATIC});
+    _entities.name(entity) = "bottomwall";
+
+    /* Ball */
+    _ball = _entities.spawn({0.0f, 0.0f},
+                            {BALL_SIZE, BALL_SIZE},
+                            {1.0f, 1.0f, 1.0f},
+                            Entities::DISPLAY | Entities::PHYSICS | Entities::BULLET,
+                            {Behavior::BALL, Behavior::SERVE});
+    _entities.name(_ball) = "ball";
+    for (size_t i = 1; i < _balls; i++)
+    {
+        _entities.spawn({0.0f, 0.0f},
+                        {BALL_SIZE, BALL_SIZE},
+                        {1.0f, 1.0f, 1.0f},
+                        Entities::DISPLAY | Entities::PHYSICS | Entities::BULLET,
+                        {Behavior::BALL, Behavior::SERVE});
+    }
+
+    /* Paddles */
+    entity = _entities.spawn({-(GAME_WIDTH / 2.0f) + PADDLE_INSET, 0.0f},
+                              {PADDLE_WIDTH, PADDLE_HEIGHT},
+                              {1.0f, 0.75f, 0.5f},
+                              Entities::DISPLAY | Entities::PHYSICS | Entities::KINEMATIC,
+                              {Behavior::PADDLE, Behavior::KEYBOARD, 0});
+    _entities.name(entity) = "rightpaddle";
+    _paddles[0] = entity;
+
+    entity = _entities.spawn({(GAME_WIDTH / 2.0f) - PADDLE_INSET, 0.0f},
+                              {PADDLE_WIDTH, PADDLE_HEIGHT},
+                              {1.0f, 0.5f, 1.0f},
+                              Entities::DISPLAY | Entities::PHYSICS | Entities::KINEMATIC,
+                              {Behavior::PADDLE, rightControl(), 1});
+    _entities.name(entity) = "leftpaddle";
+    _paddles[1] = entity;
+
+    /* Static geometry never changes during a match, index it once */
+    std::vector<uint32_t> statics;
+    for (size_t i = 0; i < _entities.count(); i++)
+    {
+        if (_entities.flags()[i] & Entities::STATIC)
+        {
+            statics.push_back(i);
+        }
+    }
+    _staticGrid.build(statics.data(), statics.size(), _entities.pos(), _entities.size());
+    memcpy(_prevPos.data(), _entities.pos(), _entities.count() * sizeof(glm::vec2));
+    _state.idle = true;
+}
+
+void World::reset()
+{
+    if (_fixed)
+    {
+        _fixed->reset();
+    }
+    auto first = _entities.index(_ball);
+    for (auto ball = first; ball < first + _balls; ball++)
+    {
+        _entities.pos()[ball] = {0.0f, 0.0f};
+        _entities.v()[ball] = {0.0f, 0.0f};
+        _prevPos[ball] = {0.0f, 0.0f};
+    }
+    _state.idle = true;
+}
+
+/* Gathers the moving bodies and copies the match state, never allocates */
+void World::save(WorldSnapshot& snapshot) const
+{
+    memset(static_cast<void*>(&snapshot), 0, sizeof(snapshot)); /* padding included, so snapshots compare with memcmp */
+    const Entities::Handle bodies[] = {_ball, _paddles[0], _paddles[1]};
+    for (int i = 0; i < WorldSnapshot::BODIES; i++)
+    {
+        auto index = _entities.index(bodies[i]);
+        auto& body = snapshot.bodies[i];
+        body.pos = _entities.pos()[index];
+        body.v = _entities.v()[index];
+        body.flags = _entities.flags()[index];
+        body.idleTicks = _entities.idleTicks()[index];
+    }
+    snapshot.world = _state;
+    if (_fixed)
+    {
+        snapshot.fixed = _fixed->state();
+    }
+}
+
+/* Goes back to a snapshot saved by a World initialized the same way */
+void World::restore(const WorldSnapshot& snapshot)
+{
+    const Entities::Handle bodies[] = {_ball, _paddles[0], _paddles[1]};
+    for (int i = 0; i < WorldSnapshot::BODIES; i++)
+    {
+        auto index = _entities.index(bodies[i]);
+        const auto& body = snapshot.bodies[i];
+        _entities.pos()[index] = body.pos;
+        _prevPos[index] = body.pos;
+        _entities.v()[index] = body.v;
+        _entities.flags()[index] = body.flags;
+        _entities.idleTicks()[index] = body.idleTicks;
+    }
+    _state = snapshot.world;
+    if (_fixed)
+    {
+        _fixed->setState(snapshot.fixed);
+    }
+}
+
+Entities& World::entities()
+{
+    return _entities;
+}
+
+const Entities& World::entities() const
+{
+    return _entities;
+}
+
+const glm::vec2* World::prevPos() const
+{
+    return _prevPos.data();
+}
+
+Entities::Handle World::ball() const
+{
+    return _ball;
+}
+
+const int* World::scores() const
+{
+    return _state.scores;
+}
+
+bool World::idle() const
+{
+    return _state.idle;
+}
+
+const Broadphase& World::broadphase() const
+{
+    return *_broadphase;
+}
+
+void World::setBroadphase(std::unique_ptr<Broadphase> broadphase)
+{
+    _broadphase = std::move(broadphase);
+}
+
+const Narrowphase& World::narrowphase() const
+{
+    return _narrowphase;
+}
+
+void World::setNarrowphase(const Narrowphase& narrowphase)
+{
+    _narrowphase = narrowphase;
+}
+
+size_t World::awakeCount() const
+{
+    return _awakeCount;
+}
+
+size_t World::movingCount() const
+{
+    return _movingCount;
+}
+
+size_t World::pairTests() const
+{
+    return _pairTests;
+}
+
+size_t World::contactCount() const
+{
+    return _contactCount;
+}
+
+uint8_t World::tick(const Keystate& input)
+{
+    return tick(input, Keystate {});
+}
+
+/* The ball starts moving once space is pressed, right is ignored with one player */
+uint8_t World::tick(const Keystate& left, const Keystate& right)
+{
+    _input[0] = left;
+    _input[1] = right;
+    memcpy(_prevPos.data(), _entities.pos(), _entities.count() * sizeof(glm::vec2));
+    if (_fixed)
+    {
+        return tickFixed();
+    }
+
+    _events = 0;
+    _tickArena.reset();
+
+    auto count = _entities.count();
+    _serve = _state.idle && (_input[0].space || _input[1].space);
+    for (size_t i = 0; i < count; i++)
+    {
+        control(i);
+    }
+    if (_serve)
+    {
+        _events |= SERVED;
+        _state.idle = false;
+    }
+
+    /*
+     * Display-only entities never have a velocity, so integrate everything in
+     * one dense pass. Bullets are moved by sweepBullets() instead.
+     */
+    auto pos = _entities.pos();
+    auto v = _entities.v();
+    auto flags = _entities.flags();
+    for (size_t i = 0; i < count; i++)
+    {
+        pos[i] += v[i] * ((flags[i] & Entities::BULLET) ? 0.0f : _dt);
+    }
+
+    /* A moving body at rest for SLEEP_TICKS falls asleep, any velocity wakes it up */
+    auto idleTicks = _entities.idleTicks();
+    for (size_t i = 0; i < count; i++)
+    {
+        if ((flags[i] & (Entities::PHYSICS | Entities::STATIC)) != Entities::PHYSICS)
+        {
+            continue;
+        }
+        if (v[i].x == 0.0f && v[i].y == 0.0f)
+        {
+            if (idleTicks[i] < SLEEP_TICKS)
+            {
+                idleTicks[i]++;
+            }
+            else
+            {
+                flags[i] |= Entities::SLEEPING;
+            }
+        }
+        else
+        {
+            idleTicks[i] = 0;
+            flags[i] &= ~Entities::SLEEPING;
+        }
+    }
+
+    /*
+     * Static bodies live in _staticGrid. Bullets never collide with each
+     * other, so only the other moving bodies go through the broadphase and
+     * the bullets are paired with them directly: thousands of balls do not
+     * turn into millions of pairs.
+     */
+    ArenaVector<uint32_t> awake {ArenaAllocator<uint32_t>(&_tickArena)};
+    ArenaVector<uint32_t> bullets {ArenaAllocator<uint32_t>(&_tickArena)};
+    ArenaVector<uint32_t> bodies {ArenaAllocator<uint32_t>(&_tickArena)};
+    awake.reserve(count);
+    bullets.reserve(count);
+    size_t movingCount = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if ((flags[i] & (Entities::PHYSICS | Entities::STATIC)) == Entities::PHYSICS)
+        {
+            movingCount++;
+            ((flags[i] & Entities::BULLET) ? bullets : bodies).push_back(i);
+            if (!(flags[i] & Entities::SLEEPING))
+            {
+                awake.push_back(i);
+            }
+        }
+    }
+
+    sweepBullets(awake.data(), awake.size(), bodies.data(), bodies.size());
+
+    auto size = _entities.size();
+    ArenaVector<BodyPair> pairs {ArenaAllocator<BodyPair>(&_tickArena)};
+    _broadphase->findPairs(bodies.data(), bodies.size(), pos, size, pairs);
+    for (auto body : bodies)
+    {
+        auto lo = pos[body] - size[body] / 2.0f;
+        auto hi = pos[body] + size[body] / 2.0f;
+        for (auto bullet : bullets)
+        {
+            auto half = size[bullet] / 2.0f;
+            if (pos[bullet].x + half.x >= lo.x && pos[bullet].x - half.x <= hi.x && pos[bullet].y + half.y >= lo.y && pos[bullet].y - half.y <= hi.y)
+            {
+                pairs.push_back({std::min(body, bullet), std::max(body, bullet)});
+            }
+        }
+    }
+    pairs.erase(std::remove_if(pairs.begin(),
+                               pairs.end(),
+                               [flags](BodyPair pair)
+                               {
+                                   return flags[pair.a] & flags[pair.b] & Entities::SLEEPING;
+                               }),
+                pairs.end());
+    _staticGrid.findPairs(awake.data(), awake.size(), pos, size, pairs);
+    _pairTests = pairs.size();
+
+    ArenaVector<Contact> contacts(pairs.size(), ArenaAllocator<Contact>(&_tickArena));
+    contacts.resize(_narrowphase.run(pairs.data(), pairs.size(), pos, size, contacts.data()));
+
+    resolve(contacts.data(), contacts.size());
+
+    _awakeCount = awake.size();
+    _movingCount = movingCount;
+    _contactCount = contacts.size();
+    return _events;
+}
+
+/* Plays the tick on _fixed, then mirrors its state into the entities */
+uint8_t World::tickFixed()
+{
+    auto events = _fixed->tick(_input[0], _input[1]);
+
+    auto pos = _entities.pos();
+    auto v = _entities.v();
+    auto ball = _entities.index(_ball);
+    pos[ball] = {_fixed->ballPos().x.toFloat(), _fixed->ballPos().y.toFloat()};
+    v[ball] = {_fixed->ballV().x.toFloat(), _fixed->ballV().y.toFloat()};
+    if (events & SCORED)
+    {
+        _prevPos[ball] = pos[ball];
+    }
+    for (int side = 0; side < 2; side++)
+    {
+        auto paddle = _entities.index(_paddles[side]);
+        pos[paddle] = {_fixed->paddlePos(side).x.toFloat(), _fixed->paddlePos(side).y.toFloat()};
+        v[paddle] = {_fixed->paddleV(side).x.toFloat(), _fixed->paddleV(side).y.toFloat()};
+        _state.scores[side] = _fixed->scores()[side];
+    }
+    _state.idle = _fixed->idle();
+
+    _awakeCount = 0;
+    _movingCount = 0;
+    _pairTests = 0;
+    _contactCount = 0;
+    return events;
+}
+
+/*
+ * Continuous collision detection. Each awake bullet moves through the tick
+ * from one time of impact to the next, bouncing off every static or moving
+ * non-bullet body it meets on the way, so that it can not tunnel through thin
+ * bodies whatever its speed or the tick rate.
+ */
+void World::sweepBullets(const uint32_t* awake, size_t awakeCount, const uint32_t* bodies, size_t bodyCount)
+{
+    auto pos = _entities.pos();
+    auto size = _entities.size();
+    auto v = _entities.v();
+    auto flags = _entities.flags();
+    auto behavior = _entities.behavior();
+
+    for (size_t i = 0; i < awakeCount; i++)
+    {
+        auto bullet = awake[i];
+        if (!(flags[bullet] & Entities::BULLET))
+        {
+            continue;
+        }
+
+        float remaining = 1.0f; /* fraction of the tick left to simulate */
+        for (int iteration = 0; iteration < MAX_SWEEPS && remaining > 0.0f; iteration++)
+        {
+            auto motion = v[bullet] * _dt * remaining;
+            SweepHit first {2.0f, {0.0f, 0.0f}};
+            uint32_t target = 0;
+
+            /* The other bodies already moved: sweep from their start position, in their frame */
+            auto test = [&](uint32_t other)
+            {
+                glm::vec2 otherMotion = (flags[other] & Entities::STATIC) ? glm::vec2 {0.0f, 0.0f} : v[other] * _dt * remaining;
+                SweepHit hit;
+                if (sweep(pos[bullet] + otherMotion, size[bullet], motion - otherMotion, pos[other], size[other], hit) && hit.t < first.t)
+                {
+                    first = hit;
+                    target = other;
+                }
+            };
+
+            auto from = pos[bullet];
+            auto to = pos[bullet] + motion;
+            _staticGrid.query(glm::min(from, to) - size[bullet] / 2.0f, glm::max(from, to) + size[bullet] / 2.0f, test);
+            for (size_t j = 0; j < bodyCount; j++)
+            {
+                test(bodies[j]);
+            }
+
+            if (first.t > 1.0f)
+            {
+                pos[bullet] = to;
+                break;
+            }
+
+            /* Move to the impact, then respond as to a contact of SWEEP_SKIN depth */
+            pos[bullet] += motion * first.t;
+            remaining *= 1.0f - first.t;
+
+            Resolution targetResolution {};
+            Resolution bulletResolution {};
+            auto event = respond(behavior[target], behavior[bullet], targetResolution, bulletResolution, first.normal * SWEEP_SKIN);
+            bulletResolution.apply(pos[bullet], v[bullet]);
+            if (event == CollisionEvent::SCORE)
+            {
+                _state.scores[behavior[target].player]++;
+                score(bullet);
+                break;
+            }
+            else if (event == CollisionEvent::PADDLE_BOUNCE)
+            {
+                _events |= PADDLE_BOUNCED;
+            }
+            else if (event == CollisionEvent::NONE)
+            {
+                /* nothing to bounce off, go through */
+                pos[bullet] += v[bullet] * _dt * remaining;
+                break;
+            }
+        }
+    }
+}
+
+void World::control(size_t entity)
+{
+    auto& v = _entities.v()[entity];
+    switch (_entities.behavior()[entity].control)
+    {
+    case Behavior::STATIC:
+        break;
+    case Behavior::SERVE:
+        if (_serve)
+        {
+            serve(v);
+        }
+
+        if (glm::length(v))
+        {
+            v = glm::normalize(v) * BALL_SPEED;
+        }
+        break;
+    case Behavior::KEYBOARD:
+    {
+        const auto& input = _input[_entities.behavior()[entity].player];
+        if (input.up)
+        {
+            v.y = -PADDLE_SPEED;
+        }
+        else if (input.down)
+        {
+            v.y = PADDLE_SPEED;
+        }
+        else
+        {
+            v.y = 0.0f;
+        }
+    }
+    break;
+    case Behavior::CPU:
+    {
+        auto selfPos = _entities.pos()[entity];
+        auto ball = target(selfPos);
+        auto ballPos = _entities.pos()[ball];
+        auto ballV = _entities.v()[ball];
+        if (ballV.x > 0.0f && ballPos.y < selfPos.y)
+        {
+            v.y = -PADDLE_SPEED;
+        }
+        else if (ballV.x > 0.0f && ballPos.y > selfPos.y)
+        {
+            v.y = PADDLE_SPEED;
+        }
+        else if (ballV.x < 0.0f && ballPos.y < selfPos.y)
+        {
+            v.y = PADDLE_SPEED;
+        }
+        else if (ballV.x < 0.0f && ballPos.y > selfPos.y)
+        {
+            v.y = -PADDLE_SPEED;
+        }
+        else
+        {
+            v.y = 0.0f;
+        }
+    }
+    break;
+    case Behavior::BOT:
+    {
+        auto selfPos = _entities.pos()[entity];
+        auto ball = target(selfPos);
+        auto& bot = _state.bots[_entities.behavior()[entity].player];
+        v.y = bot.think(_botSkill, selfPos, _entities.pos()[ball], _entities.v()[ball], PADDLE_SPEED * _dt, _state.rng) * PADDLE_SPEED;
+    }
+    break;
+    case Behavior::MLP:
+    {
+        auto selfPos = _entities.pos()[entity];
+        auto ball = target(selfPos);
+        v.y = _policy->act(_entities.pos()[ball], _entities.v()[ball], selfPos.y, selfPos.x > 0.0f ? 1.0f : -1.0f) * PADDLE_SPEED;
+    }
+    break;
+    case Behavior::TABLE:
+    {
+        auto selfPos = _entities.pos()[entity];
+        auto ball = target(selfPos);
+        v.y = _table->act(_entities.pos()[ball], _entities.v()[ball], selfPos.y, selfPos.x > 0.0f ? 1.0f : -1.0f) * PADDLE_SPEED;
+    }
+    break;
+    }
+}
+
+/* A random direction towards the right */
+void World::serve(glm::vec2& v)
+{
+    do
+    {
+        v = glm::vec2 {(_state.rng.fnext() * 2.0f) - 1.0f, (_state.rng.fnext() * 2.0f) - 1.0f};
+    } while (v.x < 0.01f);
+}
+
+/* One ball waits for the next serve, a multiball one is served again from the center */
+void World::score(size_t ball)
+{
+    _events |= SCORED;
+    if (_balls == 1)
+    {
+        reset();
+        return;
+    }
+    _entities.pos()[ball] = {0.0f, 0.0f};
+    _prevPos[ball] = {0.0f, 0.0f};
+    serve(_entities.v()[ball]);
+    _entities.v()[ball] = glm::normalize(_entities.v()[ball]) * BALL_SPEED;
+}
+
+/* The second player, or the computer: a table or a policy when set, else the bot */
+Behavior::Control World::rightControl() const
+{
+    if (_players == 2)
+    {
+        return Behavior::KEYBOARD;
+    }
+    if (_table)
+    {
+        return Behavior::TABLE;
+    }
+    return _policy ? Behavior::MLP : Behavior::BOT;
+}
+
+/* The ball coming towards a CPU paddle which is the closest to it, or the first ball */
+size_t World::target(glm::vec2 paddle) const
+{
+    auto first = _entities.index(_ball);
+    if (_balls == 1)
+    {
+        return first;
+    }
+
+    auto pos = _entities.pos();
+    auto v = _entities.v();
+    auto target = first;
+    float closest = GAME_WIDTH;
+    for (auto ball = first; ball < first + _balls; ball++)
+    {
+        float distance = (paddle.x - pos[ball].x) * (paddle.x > 0.0f ? 1.0f : -1.0f);
+        if (v[ball].x * paddle.x > 0.0f && distance >= 0.0f && distance < closest)
+        {
+            target = ball;
+            closest = distance;
+        }
+    }
+    return target;
+}
+
+/*
+ * Every contact notifies both of its bodies. Responses accumulate per body and
+ * are applied once all contacts have been seen, so the outcome does not depend
+ * on the order of the contacts.
+ */
+void World::resolve(const Contact* contacts, size_t count)
+{
+    auto entityCount = _entities.count();
+    ArenaVector<Resolution> resolutions(entityCount, Resolution {}, ArenaAllocator<Resolution>(&_tickArena));
+    auto behavior = _entities.behavior();
+
+    bool paddleBounce = false;
+    ArenaVector<uint32_t> scored {ArenaAllocator<uint32_t>(&_tickArena)};
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto& contact = contacts[i];
+        for (int side = 0; side < 2; side++)
+        {
+            auto self = side ? contact.b : contact.a;
+            auto other = side ? contact.a : contact.b;
+            auto pv = side ? -contact.pv : contact.pv;
+            switch (respond(behavior[self], behavior[other], resolutions[self], resolutions[other], pv))
+            {
+            case CollisionEvent::NONE:
+            case CollisionEvent::WALL_BOUNCE:
+                break;
+            case CollisionEvent::PADDLE_BOUNCE:
+                paddleBounce = true;
+                break;
+            case CollisionEvent::SCORE:
+                _state.scores[behavior[self].player]++;
+                scored.push_back(other);
+                break;
+            }
+        }
+    }
+
+    auto pos = _entities.pos();
+    auto v = _entities.v();
+    for (size_t i = 0; i < entityCount; i++)
+    {
+        resolutions[i].apply(pos[i], v[i]);
+    }
+
+    for (auto ball : scored)
+    {
+        score(ball);
+    }
+    if (paddleBounce)
+    {
+        _events |= PADDLE_BOUNCED;
+    }
+}
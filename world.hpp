@@ -0,0 +1,168 @@
+#pragma once
+
+#include "aligned.hpp"
+#include "arena.hpp"
+#include "bot.hpp"
+#include "broadphase.hpp"
+#include "entities.hpp"
+#include "narrowphase.hpp"
+#include "rng.hpp"
+#include <glm/glm.hpp>
+#include <memory>
+#include <stdint.h>
+
+struct Keystate
+{
+    bool up;
+    bool down;
+    bool left;
+    bool right;
+    bool space;
+};
+
+/* Keys as five bits, for recordings and network packets */
+inline uint8_t packKeys(const Keystate& input)
+{
+    return input.up | (input.down << 1) | (input.left << 2) | (input.right << 3) | (input.space << 4);
+}
+
+inline Keystate unpackKeys(uint8_t keys)
+{
+    return {(keys & 1) != 0, (keys & 2) != 0, (keys & 4) != 0, (keys & 8) != 0, (keys & 16) != 0};
+}
+
+class FixedWorld;
+class MlpPolicy;
+class PolicyTable;
+struct WorldSnapshot;
+
+/*
+ * World state, rules and the fixed step tick of a match.
+ *
+ * It has no window, renderer nor audio device: tick() reports what happened
+ * as a set of event flags and the frontend decides what to play or draw.
+ * Everything it needs is allocated up front, so ticking never allocates.
+ *
+ * With two players the right paddle is driven by a second Keystate instead of
+ * the CPU, and either player can serve.
+ *
+ * With Physics::FIXED the match is played by a FixedWorld instead, bit for
+ * bit the same on every platform, and the ball and paddle entities only
+ * mirror its state for display. Its right paddle is always the CPU chase:
+ * the bot skill, policy and table are not used.
+ *
+ * Multiball, a load test for the physics and the renderer, plays up to
+ * MAX_BALLS balls at once. They all follow the ball rules and are served
+ * together, then every ball which scores is served again from the center
+ * right away instead of stopping the match. Balls go through each other.
+ *
+ * The positions before the last tick are kept next to the current ones, so
+ * the frontend can draw any instant between the two ticks. Bodies which jump,
+ * like the ball going back to the center after a point, get the same previous
+ * and current position.
+ */
+class World
+{
+public:
+    static constexpr auto FPS = 60; /* default tick rate */
+    static constexpr auto dT = 1.0f / FPS;
+    static constexpr auto MAX_ENTITIES = 256;
+    static constexpr auto SLEEP_TICKS = 30;
+    static constexpr auto MAX_SWEEPS = 4;        /* impacts handled per bullet per tick */
+    static constexpr auto SWEEP_SKIN = 0.0001f; /* gap left between a bullet and what it hit */
+    static constexpr auto ARENA_SIZE = 64 * 1024;
+    static constexpr auto MAX_BALLS = 100000;
+
+    /* Returned by tick() */
+    static constexpr uint8_t SERVED = 1;
+    static constexpr uint8_t PADDLE_BOUNCED = 2;
+    static constexpr uint8_t SCORED = 4;
+
+    enum class Physics : uint8_t
+    {
+        FLOAT,
+        FIXED,
+    };
+
+    /* Match state besides the bodies, trivially copyable */
+    struct State
+    {
+        int scores[2];
+        Rng rng;
+        bool idle;
+        Bot bots[2]; /* of the Behavior::BOT paddles, by player */
+    };
+
+    World();
+    ~World();
+    void setPhysics(Physics physics); /* before init() */
+    Physics physics() const;
+    void setPlayers(int players); /* 1 or 2, before init() */
+    int players() const;
+    void setBalls(size_t balls); /* 1 to MAX_BALLS, before init(), float physics only */
+    size_t balls() const;
+    void setBotSkill(const BotSkill& skill); /* of the BOT paddles, normal by default */
+    void setPolicy(const MlpPolicy* policy); /* plays instead of the bot when set, before init() */
+    void setTable(const PolicyTable* table); /* same, mapped */
+    void setTickRate(int hz); /* ticks per second, FPS by default */
+    int tickRate() const;
+    float dt() const;
+    void init(uint64_t seed);
+    uint8_t tick(const Keystate& input);
+    uint8_t tick(const Keystate& left, const Keystate& right);
+    void reset();
+    void save(WorldSnapshot& snapshot) const; /* first ball only */
+    void restore(const WorldSnapshot& snapshot);
+
+    Entities& entities();
+    const Entities& entities() const;
+    const glm::vec2* prevPos() const; /* entity positions before the last tick */
+    Entities::Handle ball() const; /* the first one in multiball, the others follow it */
+    const int* scores() const;
+    bool idle() const;
+    const Broadphase& broadphase() const;
+    void setBroadphase(std::unique_ptr<Broadphase> broadphase);
+    const Narrowphase& narrowphase() const;
+    void setNarrowphase(const Narrowphase& narrowphase);
+
+    /* Statistics of the last tick */
+    size_t awakeCount() const;
+    size_t movingCount() const;
+    size_t pairTests() const;
+    size_t contactCount() const;
+
+private:
+    Entities _entities;
+    AlignedVector<glm::vec2> _prevPos;
+    StaticGrid _staticGrid;
+    std::unique_ptr<Broadphase> _broadphase;
+    Narrowphase _narrowphase;
+    Arena _tickArena; /* reset at the start of every tick() */
+    Keystate _input[2]; /* per player */
+    int _players;
+    size_t _balls;
+    BotSkill _botSkill;
+    const MlpPolicy* _policy;
+    const PolicyTable* _table;
+    int _tickRate;
+    float _dt;
+    State _state;
+    Entities::Handle _ball;
+    Entities::Handle _paddles[2];
+    std::unique_ptr<FixedWorld> _fixed;
+    uint8_t _events;
+    bool _serve; /* the balls are served during this tick */
+    size_t _awakeCount;
+    size_t _movingCount;
+    size_t _pairTests;
+    size_t _contactCount;
+
+    uint8_t tickFixed();
+    void control(size_t entity);
+    Behavior::Control rightControl() const;
+    void serve(glm::vec2& v);
+    void score(size_t ball);
+    size_t target(glm::vec2 paddle) const;
+    void sweepBullets(const uint32_t* awake, size_t awakeCount, const uint32_t* bodies, size_t bodyCount);
+    void resolve(const Contact* contacts, size_t count);
+};